@@ -0,0 +1,122 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_BENCHMARKS_BENCHMARK_HPP
+#define NDN_SVS_BENCHMARKS_BENCHMARK_HPP
+
+// Each benchmark is a single translation unit, so the allocation
+// hooks below are defined exactly once per program.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace ndn {
+namespace svs {
+namespace benchmark {
+
+std::atomic<uint64_t> g_nAllocs{0};
+std::atomic<uint64_t> g_allocBytes{0};
+
+} // namespace benchmark
+} // namespace svs
+} // namespace ndn
+
+void*
+operator new(size_t size)
+{
+  ndn::svs::benchmark::g_nAllocs.fetch_add(1, std::memory_order_relaxed);
+  ndn::svs::benchmark::g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace ndn {
+namespace svs {
+namespace benchmark {
+
+/**
+ * @brief Measure an operation and print the result as one JSON object per line
+ *
+ * The operation is run repeatedly until minDuration has passed, after one
+ * untimed warm-up run. Keys of the output object:
+ *   benchmark, entries, iterations, ns_per_op, allocs_per_op,
+ *   alloc_bytes_per_op, and bytes if the operation reports a size.
+ *
+ * @param name Name of the benchmark
+ * @param entries Size parameter of the run
+ * @param op Operation to measure; returns the number of bytes it produced, or 0
+ */
+template<typename Op>
+void
+run(const std::string& name, size_t entries, Op&& op,
+    std::chrono::milliseconds minDuration = std::chrono::milliseconds(200))
+{
+  size_t bytes = op();
+
+  uint64_t allocsBefore = g_nAllocs.load(std::memory_order_relaxed);
+  uint64_t allocBytesBefore = g_allocBytes.load(std::memory_order_relaxed);
+  auto start = std::chrono::steady_clock::now();
+
+  uint64_t iterations = 0;
+  std::chrono::steady_clock::duration elapsed;
+  do {
+    bytes = op();
+    ++iterations;
+    elapsed = std::chrono::steady_clock::now() - start;
+  } while (elapsed < minDuration);
+
+  double nsPerOp = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+  double allocsPerOp = double(g_nAllocs.load(std::memory_order_relaxed) - allocsBefore) / iterations;
+  double allocBytesPerOp = double(g_allocBytes.load(std::memory_order_relaxed) - allocBytesBefore) /
+                           iterations;
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "{\"benchmark\": \"" << name << "\""
+            << ", \"entries\": " << entries
+            << ", \"iterations\": " << iterations
+            << ", \"ns_per_op\": " << nsPerOp
+            << ", \"allocs_per_op\": " << allocsPerOp
+            << ", \"alloc_bytes_per_op\": " << allocBytesPerOp;
+  if (bytes > 0)
+    std::cout << ", \"bytes\": " << bytes;
+  std::cout << "}" << std::endl;
+}
+
+} // namespace benchmark
+} // namespace svs
+} // namespace ndn
+
+#endif // NDN_SVS_BENCHMARKS_BENCHMARK_HPP
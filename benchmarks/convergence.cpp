@@ -0,0 +1,224 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+/**
+ * Multi-node convergence benchmark
+ *
+ * Runs a group of SocketShared instances in one process, each on a
+ * DummyClientFace attached to a simulated broadcast medium, publishes
+ * a workload and reports how quickly every update reaches every node.
+ *
+ * Usage: convergence [nodes=N] [updates=N] [rate=UPDATES_PER_S]
+ *                    [delay=MS] [loss=P] [bandwidth=BITS_PER_S]
+ *                    [timeout=S] [seed=N]
+ */
+
+#include "network.hpp"
+
+#include <ndn-svs/socket-shared.hpp>
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <iostream>
+
+using namespace ndn;
+using namespace ndn::svs;
+using namespace ndn::svs::benchmark;
+
+struct Update
+{
+  time::steady_clock::TimePoint published;
+  time::steady_clock::TimePoint lastReceived;
+  size_t nReceived = 0;
+};
+
+class ConvergenceBenchmark
+{
+public:
+  ConvergenceBenchmark(const std::map<std::string, std::string>& args)
+    : m_keyChain("pib-memory:", "tpm-memory:")
+    , m_nNodes(getArg<size_t>(args, "nodes", 50))
+    , m_nUpdates(getArg<size_t>(args, "updates", 200))
+    , m_rate(getArg<double>(args, "rate", 20))
+    , m_timeout(time::seconds(getArg<int>(args, "timeout", 60)))
+    , m_rng(getArg<uint32_t>(args, "seed", 1))
+    , m_scheduler(m_io)
+  {
+    LinkOptions link;
+    link.delay = time::milliseconds(getArg<int>(args, "delay", 10));
+    link.lossRate = getArg<double>(args, "loss", 0);
+    link.bandwidth = getArg<double>(args, "bandwidth", 0);
+    m_medium = make_unique<BroadcastMedium>(m_io, Name(GROUP_PREFIX).append("s"), link,
+                                            getArg<uint32_t>(args, "seed", 1));
+
+    SecurityOptions securityOptions;
+    securityOptions.dataSigningInfo = security::signingWithSha256();
+
+    for (size_t i = 0; i < m_nNodes; ++i)
+    {
+      NodeID id = "node-" + std::to_string(i);
+      auto face = make_unique<util::DummyClientFace>(m_io, m_keyChain,
+                                                     util::DummyClientFace::Options{true, true});
+      m_medium->connect(*face);
+
+      auto socket = make_unique<SocketShared>(Name(GROUP_PREFIX), id, *face,
+                                              bind(&ConvergenceBenchmark::onMissingData, this, i, _1),
+                                              securityOptions);
+      m_faces.push_back(std::move(face));
+      m_sockets.push_back(std::move(socket));
+    }
+  }
+
+  void
+  run()
+  {
+    // Let the prefix registrations complete
+    m_io.poll();
+
+    auto interval = time::nanoseconds(static_cast<int64_t>(1e9 / m_rate));
+    for (size_t i = 0; i < m_nUpdates; ++i)
+      m_scheduler.schedule(interval * static_cast<int64_t>(i + 1), [this] { publish(); });
+
+    m_start = time::steady_clock::now();
+    checkDone();
+    m_io.run();
+  }
+
+  void
+  report() const
+  {
+    std::vector<double> convergence, fetchLatency(m_fetchLatency);
+    size_t nConverged = 0;
+    for (const auto& update : m_updates)
+    {
+      if (update.second.nReceived + 1 < m_nNodes)
+        continue;
+      ++nConverged;
+      convergence.push_back(time::duration_cast<time::microseconds>(
+        update.second.lastReceived - update.second.published).count() / 1000.0);
+    }
+
+    const auto& counters = m_medium->getCounters();
+    double nUpdates = std::max<size_t>(1, m_updates.size());
+
+    std::cout << "{\"benchmark\": \"convergence\""
+              << ", \"nodes\": " << m_nNodes
+              << ", \"updates\": " << m_updates.size()
+              << ", \"converged\": " << nConverged
+              << ", \"convergence_ms_p50\": " << percentile(convergence, 0.5)
+              << ", \"convergence_ms_p99\": " << percentile(convergence, 0.99)
+              << ", \"convergence_ms_max\": " << percentile(convergence, 1)
+              << ", \"sync_interests_per_update\": " << counters.syncInterests / nUpdates
+              << ", \"data_interests\": " << counters.dataInterests
+              << ", \"data\": " << counters.data
+              << ", \"duplicate_data\": " << counters.duplicateData
+              << ", \"lost\": " << counters.lost
+              << ", \"bytes\": " << counters.bytes
+              << ", \"fetch_latency_ms_p50\": " << percentile(fetchLatency, 0.5)
+              << ", \"fetch_latency_ms_p90\": " << percentile(fetchLatency, 0.9)
+              << ", \"fetch_latency_ms_p99\": " << percentile(fetchLatency, 0.99)
+              << "}" << std::endl;
+  }
+
+private:
+  void
+  publish()
+  {
+    size_t i = std::uniform_int_distribution<size_t>(0, m_nNodes - 1)(m_rng);
+    auto& socket = *m_sockets[i];
+
+    NodeID id = "node-" + std::to_string(i);
+    SeqNo seq = socket.getLogic().getSeqNo() + 1;
+    m_updates[{id, seq}].published = time::steady_clock::now();
+
+    std::string payload = "update " + std::to_string(seq) + " from " + id;
+    socket.publishData(reinterpret_cast<const uint8_t*>(payload.data()), payload.size(),
+                       time::milliseconds(1000));
+  }
+
+  void
+  onMissingData(size_t node, const std::vector<MissingDataInfo>& v)
+  {
+    auto reported = time::steady_clock::now();
+    for (const auto& info : v)
+    {
+      for (SeqNo s = info.low; s <= info.high; ++s)
+      {
+        NodeID nid = info.session;
+        m_sockets[node]->fetchData(nid, s, [this, nid, s, reported] (const Data&) {
+          auto now = time::steady_clock::now();
+          m_fetchLatency.push_back(time::duration_cast<time::microseconds>(now - reported).count() /
+                                   1000.0);
+
+          auto it = m_updates.find({nid, s});
+          if (it != m_updates.end())
+          {
+            ++it->second.nReceived;
+            it->second.lastReceived = now;
+          }
+        }, 3);
+      }
+    }
+  }
+
+  void
+  checkDone()
+  {
+    m_medium->clearLogs();
+
+    bool isDone = m_updates.size() == m_nUpdates &&
+                  std::all_of(m_updates.begin(), m_updates.end(), [this] (const auto& u) {
+                    return u.second.nReceived + 1 >= m_nNodes;
+                  });
+
+    if (isDone || time::steady_clock::now() - m_start > m_timeout)
+      return m_io.stop();
+
+    m_scheduler.schedule(time::milliseconds(100), [this] { checkDone(); });
+  }
+
+private:
+  static const std::string GROUP_PREFIX;
+
+  boost::asio::io_service m_io;
+  KeyChain m_keyChain;
+
+  const size_t m_nNodes;
+  const size_t m_nUpdates;
+  const double m_rate;
+  const time::nanoseconds m_timeout;
+  std::mt19937 m_rng;
+
+  ndn::Scheduler m_scheduler;
+  std::unique_ptr<BroadcastMedium> m_medium;
+  std::vector<std::unique_ptr<util::DummyClientFace>> m_faces;
+  std::vector<std::unique_ptr<SocketShared>> m_sockets;
+
+  time::steady_clock::TimePoint m_start;
+  std::map<std::pair<NodeID, SeqNo>, Update> m_updates;
+  std::vector<double> m_fetchLatency;
+};
+
+const std::string ConvergenceBenchmark::GROUP_PREFIX = "/ndn/svs";
+
+int
+main(int argc, char** argv)
+{
+  ConvergenceBenchmark benchmark(parseArgs(argc, argv));
+  benchmark.run();
+  benchmark.report();
+  return 0;
+}
@@ -0,0 +1,218 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_BENCHMARKS_NETWORK_HPP
+#define NDN_SVS_BENCHMARKS_NETWORK_HPP
+
+#include <ndn-svs/common.hpp>
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace ndn {
+namespace svs {
+namespace benchmark {
+
+/**
+ * @brief Parameters of the simulated link
+ */
+struct LinkOptions
+{
+  /** One-way propagation delay */
+  time::milliseconds delay = time::milliseconds(10);
+  /** Probability that a packet is lost, independently for each receiver */
+  double lossRate = 0;
+  /** Capacity of the shared channel in bits per second, 0 for unlimited */
+  double bandwidth = 0;
+};
+
+/**
+ * @brief Broadcast medium joining a set of DummyClientFaces
+ *
+ * Every packet sent by a face is delivered to all other faces after
+ * the propagation delay, unless lost. With a finite bandwidth, packets
+ * are serialized on a single channel shared by all faces.
+ */
+class BroadcastMedium : noncopyable
+{
+public:
+  struct Counters
+  {
+    uint64_t syncInterests = 0;
+    uint64_t dataInterests = 0;
+    uint64_t data = 0;
+    /** Data packets sent for a name that was already sent */
+    uint64_t duplicateData = 0;
+    uint64_t bytes = 0;
+    uint64_t lost = 0;
+  };
+
+  BroadcastMedium(boost::asio::io_service& io, const Name& syncPrefix,
+                  const LinkOptions& options, uint32_t seed)
+    : m_scheduler(io)
+    , m_syncPrefix(syncPrefix)
+    , m_options(options)
+    , m_rng(seed)
+  {
+  }
+
+  void
+  connect(util::DummyClientFace& face)
+  {
+    size_t index = m_faces.size();
+    m_faces.push_back(&face);
+
+    face.onSendInterest.connect([this, index] (const Interest& interest) {
+      if (m_syncPrefix.isPrefixOf(interest.getName()))
+        ++m_counters.syncInterests;
+      else
+        ++m_counters.dataInterests;
+      broadcast(index, interest);
+    });
+
+    face.onSendData.connect([this, index] (const Data& data) {
+      ++m_counters.data;
+      if (++m_dataSent[data.getName()] > 1)
+        ++m_counters.duplicateData;
+      broadcast(index, data);
+    });
+  }
+
+  const Counters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+  /// @brief Drop the packet logs kept by the faces
+  void
+  clearLogs()
+  {
+    for (auto face : m_faces)
+    {
+      face->sentInterests.clear();
+      face->sentData.clear();
+      face->sentNacks.clear();
+    }
+  }
+
+private:
+  template<typename Packet>
+  void
+  broadcast(size_t from, const Packet& packet)
+  {
+    size_t size = packet.wireEncode().size();
+    m_counters.bytes += size;
+
+    // Serialize on the shared channel
+    auto now = time::steady_clock::now();
+    auto start = std::max(now, m_channelFree);
+    time::nanoseconds txTime(0);
+    if (m_options.bandwidth > 0)
+      txTime = time::nanoseconds(static_cast<int64_t>(size * 8 * 1e9 / m_options.bandwidth));
+    m_channelFree = start + txTime;
+
+    auto delay = m_channelFree - now + m_options.delay;
+    std::uniform_real_distribution<> lossDist(0, 1);
+
+    for (size_t to = 0; to < m_faces.size(); ++to)
+    {
+      if (to == from)
+        continue;
+
+      if (m_options.lossRate > 0 && lossDist(m_rng) < m_options.lossRate)
+      {
+        ++m_counters.lost;
+        continue;
+      }
+
+      auto face = m_faces[to];
+      m_scheduler.schedule(time::duration_cast<time::nanoseconds>(delay),
+                           [face, packet] { face->receive(packet); });
+    }
+  }
+
+private:
+  ndn::Scheduler m_scheduler;
+  const Name m_syncPrefix;
+  const LinkOptions m_options;
+  std::mt19937 m_rng;
+
+  std::vector<util::DummyClientFace*> m_faces;
+  time::steady_clock::TimePoint m_channelFree;
+
+  Counters m_counters;
+  std::map<Name, uint32_t> m_dataSent;
+};
+
+/// @brief Get a percentile of a set of samples, sorting them in place
+template<typename T>
+T
+percentile(std::vector<T>& samples, double p)
+{
+  if (samples.empty())
+    return T();
+
+  std::sort(samples.begin(), samples.end());
+  size_t index = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+  return samples[index];
+}
+
+/**
+ * @brief Parse arguments of the form key=value
+ *
+ * Unknown keys are kept, so that each program picks the keys it knows.
+ */
+inline std::map<std::string, std::string>
+parseArgs(int argc, char** argv)
+{
+  std::map<std::string, std::string> args;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg(argv[i]);
+    auto eq = arg.find('=');
+    if (eq == std::string::npos)
+      args[arg] = "";
+    else
+      args[arg.substr(0, eq)] = arg.substr(eq + 1);
+  }
+  return args;
+}
+
+template<typename T>
+T
+getArg(const std::map<std::string, std::string>& args, const std::string& key, T def)
+{
+  auto it = args.find(key);
+  if (it == args.end())
+    return def;
+
+  std::istringstream is(it->second);
+  T value = def;
+  is >> value;
+  return value;
+}
+
+} // namespace benchmark
+} // namespace svs
+} // namespace ndn
+
+#endif // NDN_SVS_BENCHMARKS_NETWORK_HPP
@@ -0,0 +1,249 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+/**
+ * Large-group sync simulation in virtual time
+ *
+ * Runs N instances of the sync logic on DummyClientFaces joined by a
+ * simulated broadcast medium. Clocks are replaced with a virtual clock
+ * that is stepped by the simulation loop, and every node draws its
+ * timer jitter from its own seeded engine, so a run is reproducible
+ * bit for bit and much faster than real time.
+ *
+ * Only the sync protocol is simulated: an update counts as delivered to
+ * a node when the node learns its sequence number.
+ *
+ * Usage: scaling [nodes=N] [updates=N] [rate=UPDATES_PER_S]
+ *                [delay=MS] [loss=P] [bandwidth=BITS_PER_S]
+ *                [partitions=K] [digest=0|1] [tick=MS] [duration=S] [seed=N]
+ */
+
+#include "network.hpp"
+
+#include <ndn-svs/logic.hpp>
+
+#include <ndn-cxx/util/time-unit-test-clock.hpp>
+
+#include <chrono>
+#include <iostream>
+
+using namespace ndn;
+using namespace ndn::svs;
+using namespace ndn::svs::benchmark;
+
+struct Update
+{
+  time::steady_clock::TimePoint published;
+  time::steady_clock::TimePoint lastReceived;
+  size_t nReceived = 0;
+};
+
+class ScalingSimulation
+{
+public:
+  ScalingSimulation(const std::map<std::string, std::string>& args)
+    : m_steadyClock(make_shared<time::UnitTestSteadyClock>())
+    , m_systemClock(make_shared<time::UnitTestSystemClock>())
+    , m_keyChain("pib-memory:", "tpm-memory:")
+    , m_nNodes(getArg<size_t>(args, "nodes", 1000))
+    , m_nUpdates(getArg<size_t>(args, "updates", 100))
+    , m_rate(getArg<double>(args, "rate", 10))
+    , m_tick(time::milliseconds(getArg<int>(args, "tick", 1)))
+    , m_duration(time::seconds(getArg<int>(args, "duration", 120)))
+    , m_rng(getArg<uint32_t>(args, "seed", 1))
+  {
+    // Must precede the creation of any timer
+    time::setCustomClocks(m_steadyClock, m_systemClock);
+    m_scheduler = make_unique<ndn::Scheduler>(m_io);
+
+    uint32_t seed = getArg<uint32_t>(args, "seed", 1);
+    size_t nPartitions = getArg<size_t>(args, "partitions", 1);
+    bool isDigestSync = getArg<int>(args, "digest", 0) != 0;
+
+    LinkOptions link;
+    link.delay = time::milliseconds(getArg<int>(args, "delay", 10));
+    link.lossRate = getArg<double>(args, "loss", 0);
+    link.bandwidth = getArg<double>(args, "bandwidth", 0);
+    m_medium = make_unique<BroadcastMedium>(m_io, SYNC_PREFIX, link, seed);
+
+    for (size_t i = 0; i < m_nNodes; ++i)
+    {
+      auto face = make_unique<util::DummyClientFace>(m_io, m_keyChain,
+                                                     util::DummyClientFace::Options{true, true});
+      m_medium->connect(*face);
+
+      auto logic = make_unique<Logic>(*face, m_keyChain, SYNC_PREFIX,
+                                      bind(&ScalingSimulation::onUpdate, this, _1),
+                                      SecurityOptions::DEFAULT, "node-" + std::to_string(i));
+      logic->seedRandom(seed + static_cast<uint32_t>(i) + 1);
+      logic->setPartitionCount(nPartitions);
+      logic->setDigestSync(isDigestSync);
+
+      m_faces.push_back(std::move(face));
+      m_logics.push_back(std::move(logic));
+    }
+  }
+
+  ~ScalingSimulation()
+  {
+    m_logics.clear();
+    m_faces.clear();
+    m_medium.reset();
+    m_scheduler.reset();
+    time::setCustomClocks(nullptr, nullptr);
+  }
+
+  void
+  run()
+  {
+    auto interval = time::nanoseconds(static_cast<int64_t>(1e9 / m_rate));
+    for (size_t i = 0; i < m_nUpdates; ++i)
+      m_scheduler->schedule(interval * static_cast<int64_t>(i + 1), [this] { publish(); });
+
+    auto wallStart = std::chrono::steady_clock::now();
+    auto start = time::steady_clock::now();
+
+    m_io.poll();
+    size_t nTicks = 0;
+    while (time::steady_clock::now() - start < m_duration)
+    {
+      m_steadyClock->advance(m_tick);
+      m_io.poll();
+
+      // Check for convergence and trim the face logs every 100 ticks
+      if (++nTicks % 100 == 0)
+      {
+        m_medium->clearLogs();
+        if (isConverged())
+          break;
+      }
+    }
+
+    m_simulated = time::steady_clock::now() - start;
+    m_wall = std::chrono::steady_clock::now() - wallStart;
+  }
+
+  void
+  report() const
+  {
+    std::vector<double> convergence;
+    size_t nConverged = 0;
+    for (const auto& update : m_updates)
+    {
+      if (update.second.nReceived + 1 < m_nNodes)
+        continue;
+      ++nConverged;
+      convergence.push_back(time::duration_cast<time::microseconds>(
+        update.second.lastReceived - update.second.published).count() / 1000.0);
+    }
+
+    const auto& counters = m_medium->getCounters();
+    double nUpdates = std::max<size_t>(1, m_updates.size());
+    double simulatedS = time::duration_cast<time::milliseconds>(m_simulated).count() / 1000.0;
+    double wallS = std::chrono::duration<double>(m_wall).count();
+
+    std::cout << "{\"benchmark\": \"scaling\""
+              << ", \"nodes\": " << m_nNodes
+              << ", \"updates\": " << m_updates.size()
+              << ", \"converged\": " << nConverged
+              << ", \"convergence_ms_p50\": " << percentile(convergence, 0.5)
+              << ", \"convergence_ms_p99\": " << percentile(convergence, 0.99)
+              << ", \"convergence_ms_max\": " << percentile(convergence, 1)
+              << ", \"sync_interests\": " << counters.syncInterests
+              << ", \"sync_interests_per_update\": " << counters.syncInterests / nUpdates
+              << ", \"lost\": " << counters.lost
+              << ", \"bytes\": " << counters.bytes
+              << ", \"simulated_s\": " << simulatedS
+              << ", \"wall_s\": " << wallS
+              << ", \"speedup\": " << (wallS > 0 ? simulatedS / wallS : 0)
+              << "}" << std::endl;
+  }
+
+private:
+  void
+  publish()
+  {
+    size_t i = std::uniform_int_distribution<size_t>(0, m_nNodes - 1)(m_rng);
+    auto& logic = *m_logics[i];
+
+    SeqNo seq = logic.getSeqNo() + 1;
+    m_updates[{logic.getSessionName(), seq}].published = time::steady_clock::now();
+    logic.updateSeqNo(seq);
+  }
+
+  void
+  onUpdate(const std::vector<MissingDataInfo>& v)
+  {
+    auto now = time::steady_clock::now();
+    for (const auto& info : v)
+    {
+      for (SeqNo s = info.low; s <= info.high; ++s)
+      {
+        auto it = m_updates.find({info.session, s});
+        if (it == m_updates.end())
+          continue;
+
+        ++it->second.nReceived;
+        it->second.lastReceived = now;
+      }
+    }
+  }
+
+  bool
+  isConverged() const
+  {
+    return m_updates.size() == m_nUpdates &&
+           std::all_of(m_updates.begin(), m_updates.end(), [this] (const auto& u) {
+             return u.second.nReceived + 1 >= m_nNodes;
+           });
+  }
+
+private:
+  static const Name SYNC_PREFIX;
+
+  shared_ptr<time::UnitTestSteadyClock> m_steadyClock;
+  shared_ptr<time::UnitTestSystemClock> m_systemClock;
+
+  boost::asio::io_service m_io;
+  KeyChain m_keyChain;
+
+  const size_t m_nNodes;
+  const size_t m_nUpdates;
+  const double m_rate;
+  const time::nanoseconds m_tick;
+  const time::nanoseconds m_duration;
+  std::mt19937 m_rng;
+
+  std::unique_ptr<ndn::Scheduler> m_scheduler;
+  std::unique_ptr<BroadcastMedium> m_medium;
+  std::vector<std::unique_ptr<util::DummyClientFace>> m_faces;
+  std::vector<std::unique_ptr<Logic>> m_logics;
+
+  std::map<std::pair<NodeID, SeqNo>, Update> m_updates;
+  time::nanoseconds m_simulated;
+  std::chrono::steady_clock::duration m_wall;
+};
+
+const Name ScalingSimulation::SYNC_PREFIX("/ndn/svs/s");
+
+int
+main(int argc, char** argv)
+{
+  ScalingSimulation simulation(parseArgs(argc, argv));
+  simulation.run();
+  simulation.report();
+  return 0;
+}
@@ -0,0 +1,142 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "benchmark.hpp"
+
+#include <ndn-svs/logic.hpp>
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace ndn::svs;
+using ndn::svs::benchmark::run;
+
+/**
+ * Node IDs shaped like the node prefixes used by Socket,
+ * e.g. /ndn/org/site-12/node/8f3a09c2e1d4b765
+ */
+static std::vector<NodeID>
+makeNodeIds(size_t n)
+{
+  std::vector<NodeID> ids;
+  ids.reserve(n);
+
+  std::mt19937_64 rng(n);
+  char hex[17];
+  for (size_t i = 0; i < n; ++i)
+  {
+    snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(rng()));
+    ids.push_back("/ndn/org/site-" + std::to_string(i % 97) + "/node/" + hex);
+  }
+  return ids;
+}
+
+static VersionVector
+makeVector(const std::vector<NodeID>& ids, SeqNo base)
+{
+  VersionVector vv;
+  for (size_t i = 0; i < ids.size(); ++i)
+    vv.set(ids[i], base + i % 1000);
+  return vv;
+}
+
+static void
+benchmarkVersionVector(size_t n)
+{
+  auto ids = makeNodeIds(n);
+  VersionVector vv = makeVector(ids, 1);
+  ndn::Block encoded = vv.encode();
+
+  run("vv_encode", n, [&] {
+    return vv.encode().size();
+  });
+
+  run("vv_decode", n, [&] {
+    VersionVector decoded(encoded);
+    return encoded.size();
+  });
+
+  size_t i = 0;
+  run("vv_set", n, [&] {
+    const NodeID& nid = ids[i++ % n];
+    vv.set(nid, vv.get(nid) + 1);
+    return 0;
+  });
+}
+
+static void
+benchmarkLogic(size_t n)
+{
+  ndn::KeyChain keyChain("pib-memory:", "tpm-memory:");
+  ndn::util::DummyClientFace face(keyChain);
+  Logic logic(face, keyChain, "/ndn/svs", [] (const std::vector<MissingDataInfo>&) {});
+
+  auto ids = makeNodeIds(n);
+  VersionVector other = makeVector(ids, 1);
+  logic.mergeStateVector(other);
+
+  // Identical vectors: only the comparison
+  run("logic_merge_equal", n, [&] {
+    logic.mergeStateVector(other);
+    return 0;
+  });
+
+  // One percent of the entries advance in every round
+  size_t nUpdates = std::max<size_t>(1, n / 100);
+  size_t cursor = 0;
+  run("logic_merge_newer", n, [&] {
+    for (size_t j = 0; j < nUpdates; ++j)
+    {
+      const NodeID& nid = ids[cursor++ % n];
+      other.set(nid, other.get(nid) + 1);
+    }
+    logic.mergeStateVector(other);
+    return 0;
+  });
+
+  logic.enterSuppressionState(other);
+  run("logic_record", n, [&] {
+    logic.recordVector(other);
+    return 0;
+  });
+}
+
+int
+main(int argc, char** argv)
+{
+  std::vector<size_t> sizes = {10, 100, 1000, 10000, 100000};
+
+  // Optionally limit the largest size, e.g. for quick runs
+  if (argc > 1)
+  {
+    size_t max = std::strtoull(argv[1], nullptr, 10);
+    sizes.erase(std::remove_if(sizes.begin(), sizes.end(), [max] (size_t s) { return s > max; }),
+                sizes.end());
+  }
+
+  for (size_t n : sizes)
+  {
+    benchmarkVersionVector(n);
+    benchmarkLogic(n);
+  }
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "cache-policy.hpp"
+
+namespace ndn {
+namespace svs {
+
+constexpr size_t CachePolicy::MAX_TRACKED_REQUESTS;
+
+void
+CachePolicy::onRequest(const Name& name)
+{
+  ++m_requests[name];
+
+  if (m_requests.size() > MAX_TRACKED_REQUESTS)
+  {
+    for (auto it = m_requests.begin(); it != m_requests.end();)
+    {
+      it->second /= 2;
+      if (it->second == 0)
+        it = m_requests.erase(it);
+      else
+        ++it;
+    }
+  }
+}
+
+void
+CachePolicy::onHit(const Name& name)
+{
+  auto it = m_entries.find(name);
+  if (it != m_entries.end())
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+}
+
+size_t
+CachePolicy::getRequests(const Name& name) const
+{
+  auto it = m_requests.find(name);
+  return it == m_requests.end() ? 0 : it->second;
+}
+
+bool
+CachePolicy::admit(const Data& data, std::vector<Name>& evicted)
+{
+  const Name& name = data.getName();
+  size_t size = data.wireEncode().size();
+
+  if (m_entries.count(name) > 0)
+    return false;
+  if (getRequests(name) < m_minRequests)
+    return false;
+  if (m_maxPacketSize > 0 && size > m_maxPacketSize)
+    return false;
+  if (data.getFreshnessPeriod() < m_minFreshness)
+    return false;
+  if (m_filter && !m_filter(data))
+    return false;
+  if (m_byteBudget > 0 && size > m_byteBudget)
+    return false;
+
+  // Make room, least recently used first
+  while (m_byteBudget > 0 && !m_lru.empty() && m_bytes + size > m_byteBudget)
+  {
+    auto victim = m_entries.find(m_lru.back());
+    m_bytes -= victim->second.size;
+    evicted.push_back(victim->first);
+    m_entries.erase(victim);
+    m_lru.pop_back();
+  }
+
+  m_lru.push_front(name);
+  m_entries[name] = {m_lru.begin(), size};
+  m_bytes += size;
+  m_requests.erase(name);
+  return true;
+}
+
+}  // namespace svs
+}  // namespace ndn
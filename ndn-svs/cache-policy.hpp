@@ -0,0 +1,154 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_CACHE_POLICY_HPP
+#define NDN_SVS_CACHE_POLICY_HPP
+
+#include "common.hpp"
+
+#include <list>
+#include <map>
+
+namespace ndn {
+namespace svs {
+
+/**
+ * @brief Admission and replacement policy for data of other nodes
+ *
+ * A packet is admitted to the cache only if it passes every configured
+ * criterion: its name was requested often enough, it is small enough,
+ * its freshness period is long enough, and the admission filter accepts
+ * it. Admitted packets are kept in least-recently-used order within a
+ * byte budget; a packet answering an interest counts as used.
+ *
+ * Requests are counted per name. Once more than MAX_TRACKED_REQUESTS
+ * names are tracked, all counts are halved, so that old requests fade.
+ */
+class CachePolicy : noncopyable
+{
+public:
+  using AdmissionFilter = function<bool(const Data&)>;
+
+  /**
+   * @brief Only admit packets whose name was requested at least this often
+   *
+   * Interests received from other nodes for the name before the packet
+   * arrived are counted. 0 admits regardless of requests (default).
+   */
+  void
+  setMinRequests(size_t nRequests)
+  {
+    m_minRequests = nRequests;
+  }
+
+  /// @brief Only admit packets of at most this many bytes, 0 for any size (default)
+  void
+  setMaxPacketSize(size_t size)
+  {
+    m_maxPacketSize = size;
+  }
+
+  /// @brief Only admit packets with at least this freshness period (default zero)
+  void
+  setMinFreshness(time::milliseconds freshness)
+  {
+    m_minFreshness = freshness;
+  }
+
+  /// @brief Only admit packets the filter accepts, e.g. of some producers
+  void
+  setAdmissionFilter(const AdmissionFilter& filter)
+  {
+    m_filter = filter;
+  }
+
+  /**
+   * @brief Set the total size of the cached packets, 0 for unlimited (default)
+   *
+   * Lowering the budget takes effect on the next admission.
+   */
+  void
+  setByteBudget(size_t budget)
+  {
+    m_byteBudget = budget;
+  }
+
+  /// @brief Count an interest for a packet that is not cached
+  void
+  onRequest(const Name& name);
+
+  /// @brief Mark a cached packet as used
+  void
+  onHit(const Name& name);
+
+  /**
+   * @brief Decide whether to cache a packet
+   *
+   * If the packet is admitted, it is recorded as the most recently used,
+   * and the least recently used packets are evicted to stay within budget.
+   *
+   * @param data The packet
+   * @param evicted Receives the names of the packets to remove from the store
+   * @return whether the packet is to be inserted in the store
+   */
+  bool
+  admit(const Data& data, std::vector<Name>& evicted);
+
+  /// @brief Number of cached packets
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  /// @brief Total size of the cached packets in bytes
+  size_t
+  getBytes() const
+  {
+    return m_bytes;
+  }
+
+  /// @brief Number of requests counted for a name
+  size_t
+  getRequests(const Name& name) const;
+
+public:
+  static constexpr size_t MAX_TRACKED_REQUESTS = 10000;
+
+private:
+  size_t m_minRequests = 0;
+  size_t m_maxPacketSize = 0;
+  time::milliseconds m_minFreshness = time::milliseconds::zero();
+  AdmissionFilter m_filter;
+  size_t m_byteBudget = 0;
+
+  std::map<Name, size_t> m_requests;
+
+  struct Entry
+  {
+    std::list<Name>::iterator lru;
+    size_t size;
+  };
+  // Most recently used first
+  std::list<Name> m_lru;
+  std::map<Name, Entry> m_entries;
+  size_t m_bytes = 0;
+};
+
+}  // namespace svs
+}  // namespace ndn
+
+#endif // NDN_SVS_CACHE_POLICY_HPP
@@ -23,7 +23,7 @@
 #include <ndn-cxx/security/validator.hpp>
 #include <ndn-cxx/face.hpp>
 
-#ifdef NDN_SVS_HAVE_TESTS
+#if defined(NDN_SVS_HAVE_TESTS) || defined(NDN_SVS_HAVE_BENCHMARKS)
 #define NDN_SVS_PUBLIC_WITH_TESTS_ELSE_PRIVATE public
 #else
 #define NDN_SVS_PUBLIC_WITH_TESTS_ELSE_PRIVATE private
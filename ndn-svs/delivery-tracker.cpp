@@ -0,0 +1,149 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "delivery-tracker.hpp"
+
+namespace ndn {
+namespace svs {
+
+void
+DeliveryTracker::setKnown(const NodeID& nid, const SeqNo& high)
+{
+  Node& node = m_nodes[nid];
+  node.known = std::max(node.known, high);
+}
+
+SeqNo
+DeliveryTracker::getKnown(const NodeID& nid) const
+{
+  auto it = m_nodes.find(nid);
+  return it == m_nodes.end() ? 0 : it->second.known;
+}
+
+bool
+DeliveryTracker::markDelivered(const NodeID& nid, const SeqNo& seq)
+{
+  if (seq == 0 || isDelivered(nid, seq))
+    return false;
+
+  Node& node = m_nodes[nid];
+  insert(node, seq, seq);
+  node.known = std::max(node.known, seq);
+  return true;
+}
+
+void
+DeliveryTracker::markSkipped(const NodeID& nid, const SeqNo& low, const SeqNo& high)
+{
+  SeqNo first = std::max<SeqNo>(low, 1);
+  if (first > high)
+    return;
+
+  Node& node = m_nodes[nid];
+  insert(node, first, high);
+  node.known = std::max(node.known, high);
+}
+
+bool
+DeliveryTracker::isDelivered(const NodeID& nid, const SeqNo& seq) const
+{
+  auto it = m_nodes.find(nid);
+  if (it == m_nodes.end())
+    return false;
+
+  // Last interval starting at or below seq
+  const auto& intervals = it->second.intervals;
+  auto interval = intervals.upper_bound(seq);
+  if (interval == intervals.begin())
+    return false;
+  --interval;
+  return seq <= interval->second;
+}
+
+SeqNo
+DeliveryTracker::getWatermark(const NodeID& nid) const
+{
+  auto it = m_nodes.find(nid);
+  if (it == m_nodes.end() || it->second.intervals.empty())
+    return 0;
+
+  const auto& first = *it->second.intervals.begin();
+  return first.first == 1 ? first.second : 0;
+}
+
+std::vector<MissingDataInfo>
+DeliveryTracker::getGaps() const
+{
+  std::vector<MissingDataInfo> gaps;
+  for (const auto& entry : m_nodes)
+  {
+    const Node& node = entry.second;
+    SeqNo next = 1;
+    for (const auto& interval : node.intervals)
+    {
+      if (interval.first > next)
+        gaps.push_back({entry.first, next, interval.first - 1});
+      next = interval.second + 1;
+    }
+    if (next <= node.known)
+      gaps.push_back({entry.first, next, node.known});
+  }
+  return gaps;
+}
+
+void
+DeliveryTracker::erase(const NodeID& nid)
+{
+  m_nodes.erase(nid);
+}
+
+size_t
+DeliveryTracker::getIntervalCount(const NodeID& nid) const
+{
+  auto it = m_nodes.find(nid);
+  return it == m_nodes.end() ? 0 : it->second.intervals.size();
+}
+
+void
+DeliveryTracker::insert(Node& node, SeqNo low, SeqNo high)
+{
+  auto& intervals = node.intervals;
+
+  // Merge with an interval that overlaps or touches on the left
+  auto it = intervals.upper_bound(low);
+  if (it != intervals.begin())
+  {
+    auto prev = std::prev(it);
+    if (prev->second + 1 >= low)
+    {
+      low = prev->first;
+      high = std::max(high, prev->second);
+      it = intervals.erase(prev);
+    }
+  }
+
+  // Absorb the intervals that overlap or touch on the right
+  while (it != intervals.end() && it->first <= high + 1)
+  {
+    high = std::max(high, it->second);
+    it = intervals.erase(it);
+  }
+
+  intervals.emplace_hint(it, low, high);
+}
+
+}  // namespace svs
+}  // namespace ndn
@@ -0,0 +1,101 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_DELIVERY_TRACKER_HPP
+#define NDN_SVS_DELIVERY_TRACKER_HPP
+
+#include "logic.hpp"
+
+#include <map>
+
+namespace ndn {
+namespace svs {
+
+/**
+ * @brief Record of the seqNos delivered from each node
+ *
+ * The seqNos delivered or given up on are kept per node as a set of
+ * disjoint intervals, so that a node delivered in order takes a single
+ * entry whatever its history. Together with the highest seqNo known
+ * to exist, this gives the gaps still to be fetched.
+ */
+class DeliveryTracker : noncopyable
+{
+public:
+  /// @brief Record that the seqNos of a node up to @p high exist
+  void
+  setKnown(const NodeID& nid, const SeqNo& high);
+
+  /// @brief Highest seqNo known to exist for a node, 0 if none
+  SeqNo
+  getKnown(const NodeID& nid) const;
+
+  /**
+   * @brief Record that a seqNo was delivered
+   *
+   * @return false if it was already delivered or skipped
+   */
+  bool
+  markDelivered(const NodeID& nid, const SeqNo& seq);
+
+  /// @brief Give up on a range of seqNos, so that they are no longer gaps
+  void
+  markSkipped(const NodeID& nid, const SeqNo& low, const SeqNo& high);
+
+  /// @brief Whether a seqNo was delivered or skipped
+  bool
+  isDelivered(const NodeID& nid, const SeqNo& seq) const;
+
+  /**
+   * @brief Get the watermark of a node
+   *
+   * @return the highest seqNo such that it and all seqNos below it were
+   *         delivered or skipped, 0 if none
+   */
+  SeqNo
+  getWatermark(const NodeID& nid) const;
+
+  /// @brief Get the ranges of known seqNos neither delivered nor skipped, by node
+  std::vector<MissingDataInfo>
+  getGaps() const;
+
+  /// @brief Forget a node
+  void
+  erase(const NodeID& nid);
+
+  /// @brief Number of intervals kept for a node
+  size_t
+  getIntervalCount(const NodeID& nid) const;
+
+private:
+  struct Node
+  {
+    /** Disjoint, non-adjacent intervals, from low to high */
+    std::map<SeqNo, SeqNo> intervals;
+    SeqNo known = 0;
+  };
+
+  static void
+  insert(Node& node, SeqNo low, SeqNo high);
+
+private:
+  std::map<NodeID, Node> m_nodes;
+};
+
+}  // namespace svs
+}  // namespace ndn
+
+#endif // NDN_SVS_DELIVERY_TRACKER_HPP
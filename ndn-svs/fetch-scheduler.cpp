@@ -0,0 +1,111 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "fetch-scheduler.hpp"
+
+namespace ndn {
+namespace svs {
+
+void
+FetchScheduler::enqueue(const NodeID& nid, const Fetch& fetch)
+{
+  Queue& queue = m_queues[nid];
+  if (queue.fetches.empty())
+    m_active.push_back(nid);
+
+  queue.fetches.push_back(fetch);
+  ++m_nQueued;
+
+  dispatch();
+}
+
+void
+FetchScheduler::setPriority(const NodeID& nid, size_t priority)
+{
+  if (priority <= 1)
+    m_priorities.erase(nid);
+  else
+    m_priorities[nid] = priority;
+}
+
+size_t
+FetchScheduler::getPriority(const NodeID& nid) const
+{
+  auto it = m_priorities.find(nid);
+  return it == m_priorities.end() ? 1 : it->second;
+}
+
+void
+FetchScheduler::setMaxConcurrent(size_t maxConcurrent)
+{
+  m_maxConcurrent = maxConcurrent;
+  dispatch();
+}
+
+void
+FetchScheduler::dispatch()
+{
+  // Fetches may complete synchronously; the outer call keeps dispatching
+  if (m_isDispatching)
+    return;
+  m_isDispatching = true;
+
+  while (!m_active.empty() && (m_maxConcurrent == 0 || m_nInFlight < m_maxConcurrent))
+  {
+    NodeID nid = m_active.front();
+    Queue& queue = m_queues[nid];
+    if (queue.credit == 0)
+      queue.credit = getPriority(nid);
+
+    Fetch fetch = std::move(queue.fetches.front());
+    queue.fetches.pop_front();
+    --queue.credit;
+    --m_nQueued;
+    ++m_nInFlight;
+
+    if (queue.fetches.empty())
+    {
+      m_queues.erase(nid);
+      m_active.pop_front();
+    }
+    else if (queue.credit == 0)
+    {
+      // End of this producer's turn
+      m_active.pop_front();
+      m_active.push_back(nid);
+    }
+
+    try {
+      fetch(bind(&FetchScheduler::onDone, this));
+    }
+    catch (...) {
+      m_isDispatching = false;
+      throw;
+    }
+  }
+
+  m_isDispatching = false;
+}
+
+void
+FetchScheduler::onDone()
+{
+  --m_nInFlight;
+  dispatch();
+}
+
+}  // namespace svs
+}  // namespace ndn
@@ -0,0 +1,131 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_FETCH_SCHEDULER_HPP
+#define NDN_SVS_FETCH_SCHEDULER_HPP
+
+#include "common.hpp"
+
+#include <deque>
+#include <map>
+
+namespace ndn {
+namespace svs {
+
+/**
+ * @brief Fair scheduler for data fetches from many producers
+ *
+ * Fetches are queued per producer and dequeued round robin, so a producer
+ * with a long backlog does not delay the fetches of the others. A producer
+ * with priority p is served up to p fetches in each round. At most
+ * getMaxConcurrent() fetches are in flight at once.
+ */
+class FetchScheduler : noncopyable
+{
+public:
+  using DoneCallback = function<void()>;
+
+  /**
+   * @brief A fetch to be started by the scheduler
+   *
+   * The fetch must call the done callback exactly once when it completes,
+   * successfully or not, to release its slot.
+   */
+  using Fetch = function<void(const DoneCallback& done)>;
+
+  /**
+   * @param maxConcurrent Maximum number of fetches in flight, 0 for unlimited
+   */
+  explicit
+  FetchScheduler(size_t maxConcurrent = 0)
+    : m_maxConcurrent(maxConcurrent)
+  {
+  }
+
+  /**
+   * @brief Queue a fetch from a producer
+   *
+   * The fetch is started right away if a slot is free and no
+   * other fetch is waiting.
+   */
+  void
+  enqueue(const NodeID& nid, const Fetch& fetch);
+
+  /**
+   * @brief Set the share of fetches given to a producer
+   *
+   * @param priority Fetches served per round, at least 1 (default)
+   */
+  void
+  setPriority(const NodeID& nid, size_t priority);
+
+  size_t
+  getPriority(const NodeID& nid) const;
+
+  /// @brief Set the maximum number of fetches in flight, 0 for unlimited
+  void
+  setMaxConcurrent(size_t maxConcurrent);
+
+  size_t
+  getMaxConcurrent() const
+  {
+    return m_maxConcurrent;
+  }
+
+  /// @brief Number of fetches started and not yet done
+  size_t
+  getInFlight() const
+  {
+    return m_nInFlight;
+  }
+
+  /// @brief Number of fetches waiting for a slot
+  size_t
+  getQueued() const
+  {
+    return m_nQueued;
+  }
+
+private:
+  void
+  dispatch();
+
+  void
+  onDone();
+
+private:
+  struct Queue
+  {
+    std::deque<Fetch> fetches;
+    /** Fetches left in the current round */
+    size_t credit = 0;
+  };
+
+  size_t m_maxConcurrent;
+  size_t m_nInFlight = 0;
+  size_t m_nQueued = 0;
+  bool m_isDispatching = false;
+
+  std::map<NodeID, Queue> m_queues;
+  std::map<NodeID, size_t> m_priorities;
+  /** Producers with queued fetches, in round robin order */
+  std::deque<NodeID> m_active;
+};
+
+}  // namespace svs
+}  // namespace ndn
+
+#endif // NDN_SVS_FETCH_SCHEDULER_HPP
@@ -0,0 +1,203 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "ibf.hpp"
+#include "tlv.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace svs {
+
+constexpr size_t InvertibleBloomFilter::N_HASHES;
+
+static const size_t CELL_SIZE = 20;
+
+static uint64_t
+mix(uint64_t x)
+{
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+static uint64_t
+readUint(const uint8_t* buf, size_t len)
+{
+  uint64_t value = 0;
+  for (size_t i = 0; i < len; ++i)
+    value = (value << 8) | buf[i];
+  return value;
+}
+
+static void
+writeUint(std::vector<uint8_t>& buf, uint64_t value, size_t len)
+{
+  for (size_t i = len; i > 0; --i)
+    buf.push_back(static_cast<uint8_t>(value >> (8 * (i - 1))));
+}
+
+InvertibleBloomFilter::InvertibleBloomFilter(size_t nCells)
+  : m_cells((std::max<size_t>(nCells, 1) + N_HASHES - 1) / N_HASHES * N_HASHES)
+{
+}
+
+InvertibleBloomFilter::InvertibleBloomFilter(const ndn::Block& block)
+{
+  if (block.type() != tlv::Ibf)
+    NDN_THROW(Error("Expected Ibf"));
+
+  size_t size = block.value_size();
+  if (size == 0 || size % (CELL_SIZE * N_HASHES) != 0)
+    NDN_THROW(Error("Invalid Ibf length"));
+
+  m_cells.resize(size / CELL_SIZE);
+  const uint8_t* value = block.value();
+  for (auto& cell : m_cells)
+  {
+    cell.count = static_cast<int32_t>(readUint(value, 4));
+    cell.keySum = readUint(value + 4, 8);
+    cell.hashSum = readUint(value + 12, 8);
+    value += CELL_SIZE;
+  }
+}
+
+ndn::Block
+InvertibleBloomFilter::encode() const
+{
+  std::vector<uint8_t> buf;
+  buf.reserve(m_cells.size() * CELL_SIZE);
+  for (const auto& cell : m_cells)
+  {
+    writeUint(buf, static_cast<uint32_t>(cell.count), 4);
+    writeUint(buf, cell.keySum, 8);
+    writeUint(buf, cell.hashSum, 8);
+  }
+  return ndn::encoding::makeBinaryBlock(tlv::Ibf, buf.data(), buf.size());
+}
+
+size_t
+InvertibleBloomFilter::getCellCount(size_t expectedDifference)
+{
+  // Peeling needs about 1.23 cells per key asymptotically with three
+  // hashes; small differences need more, and fail in a few percent of
+  // the cases even then
+  return expectedDifference * 2 + 4 * N_HASHES;
+}
+
+void
+InvertibleBloomFilter::insert(uint64_t key)
+{
+  update(key, 1);
+}
+
+void
+InvertibleBloomFilter::erase(uint64_t key)
+{
+  update(key, -1);
+}
+
+void
+InvertibleBloomFilter::subtract(const InvertibleBloomFilter& other)
+{
+  if (other.m_cells.size() != m_cells.size())
+    NDN_THROW(Error("Cannot subtract filters of different sizes"));
+
+  for (size_t i = 0; i < m_cells.size(); ++i)
+  {
+    m_cells[i].count -= other.m_cells[i].count;
+    m_cells[i].keySum ^= other.m_cells[i].keySum;
+    m_cells[i].hashSum ^= other.m_cells[i].hashSum;
+  }
+}
+
+bool
+InvertibleBloomFilter::decode(std::vector<uint64_t>& positive, std::vector<uint64_t>& negative) const
+{
+  std::vector<Cell> cells(m_cells);
+
+  auto isPure = [] (const Cell& cell) {
+    return (cell.count == 1 || cell.count == -1) && cell.hashSum == getCheckHash(cell.keySum);
+  };
+
+  std::vector<size_t> pure;
+  for (size_t i = 0; i < cells.size(); ++i)
+  {
+    if (isPure(cells[i]))
+      pure.push_back(i);
+  }
+
+  while (!pure.empty())
+  {
+    size_t i = pure.back();
+    pure.pop_back();
+    if (!isPure(cells[i]))
+      continue;
+
+    uint64_t key = cells[i].keySum;
+    int32_t count = cells[i].count;
+    (count > 0 ? positive : negative).push_back(key);
+
+    // Remove the key from all its cells
+    uint64_t checkHash = getCheckHash(key);
+    for (size_t h = 0; h < N_HASHES; ++h)
+    {
+      auto& cell = cells[getIndex(key, h)];
+      cell.count -= count;
+      cell.keySum ^= key;
+      cell.hashSum ^= checkHash;
+      if (isPure(cell))
+        pure.push_back(getIndex(key, h));
+    }
+  }
+
+  for (const auto& cell : cells)
+  {
+    if (cell.count != 0 || cell.keySum != 0 || cell.hashSum != 0)
+      return false;
+  }
+  return true;
+}
+
+void
+InvertibleBloomFilter::update(uint64_t key, int32_t delta)
+{
+  uint64_t checkHash = getCheckHash(key);
+  for (size_t h = 0; h < N_HASHES; ++h)
+  {
+    auto& cell = m_cells[getIndex(key, h)];
+    cell.count += delta;
+    cell.keySum ^= key;
+    cell.hashSum ^= checkHash;
+  }
+}
+
+size_t
+InvertibleBloomFilter::getIndex(uint64_t key, size_t hash) const
+{
+  // One sub-table per hash, so that the cells of a key are distinct
+  size_t subTableSize = m_cells.size() / N_HASHES;
+  return hash * subTableSize + mix(key + hash * 0x9e3779b97f4a7c15ULL) % subTableSize;
+}
+
+uint64_t
+InvertibleBloomFilter::getCheckHash(uint64_t key)
+{
+  return mix(key ^ 0x5851f42d4c957f2dULL);
+}
+
+} // namespace svs
+} // namespace ndn
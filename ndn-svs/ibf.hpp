@@ -0,0 +1,128 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_IBF_HPP
+#define NDN_SVS_IBF_HPP
+
+#include "common.hpp"
+
+#include <vector>
+
+namespace ndn {
+namespace svs {
+
+/**
+ * @brief Invertible Bloom filter over 64-bit keys
+ *
+ * Subtracting the filter of one set from the filter of another leaves
+ * only the keys in the symmetric difference, which can be listed as long
+ * as the difference is small compared to the number of cells. Keys must
+ * be well-mixed hashes, e.g. of version vector entries.
+ *
+ *   Ibf = IBF-TYPE TLV-LENGTH *Cell
+ *   Cell = 4OCTET count 8OCTET keySum 8OCTET hashSum ; big-endian
+ */
+class InvertibleBloomFilter
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /// @brief Number of cells each key is added to
+  static constexpr size_t N_HASHES = 3;
+
+public:
+  /**
+   * @brief Create an empty filter
+   *
+   * @param nCells Number of cells, rounded up to a multiple of N_HASHES
+   */
+  explicit
+  InvertibleBloomFilter(size_t nCells);
+
+  /** Decode a filter from an Ibf block */
+  explicit
+  InvertibleBloomFilter(const ndn::Block& block);
+
+  ndn::Block
+  encode() const;
+
+  /// @brief Get a number of cells likely to decode a difference of the given size
+  static size_t
+  getCellCount(size_t expectedDifference);
+
+  size_t
+  getCellCount() const
+  {
+    return m_cells.size();
+  }
+
+  void
+  insert(uint64_t key);
+
+  void
+  erase(uint64_t key);
+
+  /**
+   * @brief Subtract another filter of the same size
+   *
+   * @throw Error if the sizes differ
+   */
+  void
+  subtract(const InvertibleBloomFilter& other);
+
+  /**
+   * @brief List the keys of a difference filter
+   *
+   * @param[out] positive keys inserted into this filter but not the subtracted one
+   * @param[out] negative keys inserted into the subtracted filter only
+   * @returns whether the whole difference could be listed
+   */
+  bool
+  decode(std::vector<uint64_t>& positive, std::vector<uint64_t>& negative) const;
+
+private:
+  struct Cell
+  {
+    int32_t count = 0;
+    uint64_t keySum = 0;
+    uint64_t hashSum = 0;
+  };
+
+  void
+  update(uint64_t key, int32_t delta);
+
+  size_t
+  getIndex(uint64_t key, size_t hash) const;
+
+  static uint64_t
+  getCheckHash(uint64_t key);
+
+private:
+  std::vector<Cell> m_cells;
+};
+
+} // namespace svs
+} // namespace ndn
+
+#endif // NDN_SVS_IBF_HPP
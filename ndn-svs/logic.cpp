@@ -15,16 +15,28 @@
  */
 
 #include "logic.hpp"
+#include "tlv.hpp"
+#include "trace.hpp"
 
 #include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/security/validator-null.hpp>
 #include <ndn-cxx/security/verification-helpers.hpp>
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace ndn {
 namespace svs {
 
 int Logic::s_instanceCounter = 0;
 
 const NodeID Logic::EMPTY_NODE_ID;
+constexpr int Logic::TOMBSTONE_LIFETIME_FACTOR;
+constexpr size_t Logic::RECOVERY_SEGMENT_SIZE;
+constexpr size_t Logic::INLINE_DATA_BUDGET;
+const time::milliseconds Logic::RECOVERY_SNAPSHOT_LIFETIME(1000);
+const ndn::name::Component Logic::RESET_COMPONENT("reset");
+const ndn::name::Component Logic::RECOVERY_COMPONENT("recovery");
 
 Logic::Logic(ndn::Face& face,
              ndn::KeyChain& keyChain,
@@ -37,30 +49,41 @@ Logic::Logic(ndn::Face& face,
   , m_securityOptions(securityOptions)
   , m_id(nid)
   , m_onUpdate(onUpdate)
-  , m_rng(ndn::random::getRandomNumberEngine())
+  , m_rng(&ndn::random::getRandomNumberEngine())
   , m_packetDist(10, 15)
-  , m_retxDist(30000 * 0.9, 30000 * 1.1)
-  , m_intrReplyDist(50 * 0.9, 50 * 1.1)
+  , m_timingPolicy(make_shared<TimingPolicy>())
   , m_keyChain(keyChain)
   , m_keyChainMem("pib-memory:", "tpm-memory:")
   , m_scheduler(m_face.getIoService())
+  , m_timers(make_unique<TimerWheel>(m_scheduler))
+  , m_nextSyncInterest(0)
   , m_instanceId(s_instanceCounter++)
 {
   // Register sync interest filter
   m_syncRegisteredPrefix =
     m_face.setInterestFilter(syncPrefix,
                              bind(&Logic::onSyncInterest, this, _2),
-                             bind(&Logic::retxSyncInterest, this, true, 0),
+                             [this] (const Name&) {
+                               if (m_isRecoveryOnJoin)
+                                 fetchRecoverySnapshot();
+                               retxSyncInterest(true, 0);
+                             },
                              [] (const Name& prefix, const std::string& msg) {});
 }
 
 Logic::~Logic()
 {
+  if (m_recoveryFetcher)
+    m_recoveryFetcher->stop();
 }
 
 void
 Logic::onSyncInterest(const Interest &interest)
 {
+  const auto& n = interest.getName();
+  if (n.size() > m_syncPrefix.size() && n.get(m_syncPrefix.size()) == RECOVERY_COMPONENT)
+    return onRecoveryInterest(interest);
+
   switch (m_securityOptions.interestSigningInfo.getSignerType())
   {
     case security::SigningInfo::SIGNER_TYPE_NULL:
@@ -72,13 +95,17 @@ Logic::onSyncInterest(const Interest &interest)
                                     m_securityOptions.interestSigningInfo.getSignerName(),
                                     DigestAlgorithm::SHA256))
         onSyncInterestValidated(interest);
+      else
+        m_metrics.syncInterestsRejected.increment();
       return;
 
     default:
       if (static_cast<bool>(m_securityOptions.validator))
         m_securityOptions.validator->validate(interest,
                                               bind(&Logic::onSyncInterestValidated, this, _1),
-                                              nullptr);
+                                              [this] (const Interest&, const ValidationError&) {
+                                                m_metrics.syncInterestsRejected.increment();
+                                              });
       else
         onSyncInterestValidated(interest);
       return;
@@ -89,25 +116,93 @@ void
 Logic::onSyncInterestValidated(const Interest &interest)
 {
   const auto &n = interest.getName();
+  m_metrics.syncInterestsReceived.increment();
+
+  if (n.size() > m_syncPrefix.size() && n.get(m_syncPrefix.size()) == RESET_COMPONENT)
+    return reset(true);
+
+  if (interest.hasApplicationParameters())
+    onInlineData(interest);
 
-  // Get state vector
+  // Only decode here; the handlers call the application, whose errors
+  // must not be taken for a malformed sync interest
+  uint32_t stateType = 0;
   std::shared_ptr<VersionVector> vvOther;
+  unique_ptr<PartitionedState> partitionedState;
+  uint64_t digest = 0;
+  unique_ptr<InvertibleBloomFilter> ibfOther;
   try
   {
-    vvOther = make_shared<VersionVector>(n.get(-2));
+    const auto& stateComponent = n.get(-2);
+    stateType = stateComponent.type();
+    if (stateType == tlv::PartitionedState)
+      partitionedState = make_unique<PartitionedState>(stateComponent);
+    else if (stateType == tlv::StateDigest)
+      digest = ndn::encoding::readNonNegativeInteger(stateComponent);
+    else if (stateType == tlv::Reconcile)
+    {
+      stateComponent.parse();
+      auto ibfBlock = stateComponent.find(tlv::Ibf);
+      if (ibfBlock != stateComponent.elements_end())
+        ibfOther = make_unique<InvertibleBloomFilter>(*ibfBlock);
+      auto vvBlock = stateComponent.find(tlv::VersionVector);
+      if (vvBlock != stateComponent.elements_end())
+        vvOther = make_shared<VersionVector>(*vvBlock);
+    }
+    else
+      vvOther = make_shared<VersionVector>(stateComponent);
+  }
+  catch (const ndn::tlv::Error&)
+  {
+    m_metrics.syncInterestsMalformed.increment();
+    return;
+  }
+  catch (const VersionVector::Error&)
+  {
+    m_metrics.syncInterestsMalformed.increment();
+    return;
+  }
+  catch (const PartitionedState::Error&)
+  {
+    m_metrics.syncInterestsMalformed.increment();
+    return;
   }
-  catch (ndn::tlv::Error&)
+  catch (const InvertibleBloomFilter::Error&)
   {
+    m_metrics.syncInterestsMalformed.increment();
     return;
   }
 
+  if (stateType == tlv::PartitionedState)
+    return onPartitionedState(*partitionedState);
+  if (stateType == tlv::StateDigest)
+    return onStateDigest(digest);
+  if (stateType == tlv::Reconcile)
+    return onReconcile(ibfOther.get(), vvOther.get());
+
+  NDN_SVS_TRACE(trace::Event::SYNC_RX, this, vvOther->size());
+
   // Merge state vector
   bool myVectorNew, otherVectorNew;
   std::tie(myVectorNew, otherVectorNew) = mergeStateVector(*vvOther);
+  NDN_SVS_TRACE(trace::Event::MERGE_RESULT, this, myVectorNew, otherVectorNew);
+
+  // After merging, the states are equal unless ours was newer
+  m_isInSync = !myVectorNew;
+
+  // A full vector covers any pending reconcile request, and the entries it carries
+  coverReconcile(*vvOther, true);
+
+  if (myVectorNew || otherVectorNew)
+    m_timingPolicy->onActivity();
 
   // Try to record; the call will check if in suppression state
   if (recordVector(*vvOther))
+  {
+    m_metrics.syncInterestsSuppressed.increment();
+    NDN_SVS_TRACE(trace::Event::SYNC_SUPPRESSED, this);
     return;
+  }
 
   // If incoming state identical/newer to local vector, reset timer
   // If incoming state is older, send sync interest immediately
@@ -119,8 +214,9 @@ Logic::onSyncInterestValidated(const Interest &interest)
   {
     enterSuppressionState(*vvOther);
     // Check how much time is left on the timer,
-    // reset to ~m_intrReplyDist if more than that.
-    int delay = m_intrReplyDist(m_rng);
+    // reset to the suppression delay if more than that.
+    int delay = m_timingPolicy->getSuppressionDelay(getGroupSize(), *m_rng).count();
+    NDN_SVS_TRACE(trace::Event::SUPPRESSION_ENTER, this, delay);
     if (getCurrentTime() + delay * 1000 < m_nextSyncInterest)
     {
       retxSyncInterest(false, delay);
@@ -128,46 +224,181 @@ Logic::onSyncInterestValidated(const Interest &interest)
   }
 }
 
+void
+Logic::onInlineData(const Interest& interest)
+{
+  Block params = interest.getApplicationParameters();
+  std::vector<Data> packets;
+  try
+  {
+    params.parse();
+    auto inlineData = params.find(tlv::InlineData);
+    if (inlineData == params.elements_end())
+      return;
+
+    inlineData->parse();
+    for (const auto& element : inlineData->elements())
+    {
+      if (element.type() == ndn::tlv::Data)
+        packets.emplace_back(element);
+    }
+  }
+  catch (const ndn::tlv::Error&)
+  {
+    m_metrics.syncInterestsMalformed.increment();
+    return;
+  }
+
+  m_metrics.inlineDataReceived.increment(packets.size());
+  if (m_onInlineData)
+  {
+    for (const auto& data : packets)
+      m_onInlineData(data);
+  }
+}
+
+void
+Logic::addInlineData(const Data& data)
+{
+  const Block& wire = data.wireEncode();
+
+  std::lock_guard<std::mutex> lock(m_inlineDataMutex);
+  if (m_inlineDataSize + wire.size() > INLINE_DATA_BUDGET)
+    return;
+
+  m_inlineData.push_back(wire);
+  m_inlineDataSize += wire.size();
+}
+
 void
 Logic::retxSyncInterest(const bool send, unsigned int delay)
 {
   if (send)
   {
     // Only send interest if in steady state or local vector has newer state
-    // than recorded interests
-    if (!m_recordedVv || mergeStateVector(*m_recordedVv).first)
+    // than recorded interests; in partitioned mode, if any partition is
+    // still to be sent after suppression
+    bool isSending;
+    if (m_isSuppressingPartitions)
+    {
+      std::lock_guard<std::mutex> lock(m_vvMutex);
+      isSending = std::find(m_dirtyPartitions.begin(), m_dirtyPartitions.end(), true) !=
+                  m_dirtyPartitions.end();
+    }
+    else
+    {
+      isSending = !m_recordedVv || mergeStateVector(*m_recordedVv).first;
+    }
+
+    if (isSending)
+    {
+      if (m_inactivityTimeout > time::milliseconds::zero())
+        pruneInactive();
       sendSyncInterest();
+    }
+
+    if (m_recordedVv || m_isSuppressingPartitions)
+      m_timingPolicy->onSuppressionEnd(m_nRecorded);
     m_recordedVv = nullptr;
+    m_isSuppressingPartitions = false;
   }
 
   if (delay == 0)
-    delay = m_retxDist(m_rng);
+    delay = m_timingPolicy->getRetxDelay(getGroupSize(), *m_rng).count();
 
   // Store the scheduled time
   m_nextSyncInterest = getCurrentTime() + 1000 * delay;
+  NDN_SVS_TRACE(trace::Event::TIMER_RESET, this, delay);
+
+  m_timers->cancel(m_retxEvent);
+  m_retxEvent = m_timers->schedule(time::milliseconds(delay),
+                                   [this] { retxSyncInterest(true, 0); });
+}
+
+void
+Logic::setTimerBackend(std::unique_ptr<TimerBackend> timers)
+{
+  bool isScheduled = m_retxEvent != TimerBackend::INVALID_TIMER;
 
-  m_retxEvent = m_scheduler.schedule(time::milliseconds(delay),
-                                     [this] { retxSyncInterest(true, 0); });
+  m_timers = std::move(timers);
+  m_retxEvent = TimerBackend::INVALID_TIMER;
+
+  // Carry over the remaining time of the next sync interest
+  if (isScheduled)
+  {
+    long remaining = (m_nextSyncInterest - getCurrentTime()) / 1000;
+    retxSyncInterest(false, std::max(remaining, 1L));
+  }
 }
 
 void
 Logic::sendSyncInterest()
 {
-  Name syncName(m_syncPrefix);
+  Block state;
 
   {
     std::lock_guard<std::mutex> lock(m_vvMutex);
-    syncName.append(Name::Component(m_vv.encode()));
+    if (m_vv.getPartitionCount() > 1)
+    {
+      std::vector<size_t> partitions;
+      for (size_t p = 0; p < m_dirtyPartitions.size(); ++p)
+      {
+        if (m_dirtyPartitions[p])
+          partitions.push_back(p);
+      }
+      std::fill(m_dirtyPartitions.begin(), m_dirtyPartitions.end(), false);
+
+      state = PartitionedState(m_vv, partitions).encode();
+    }
+    else if (m_isDigestSync && m_isInSync)
+    {
+      state = ndn::encoding::makeNonNegativeIntegerBlock(tlv::StateDigest, m_vv.getDigest());
+      m_metrics.syncDigestsSent.increment();
+    }
+    else
+    {
+      state = m_vv.encode();
+    }
+    NDN_SVS_TRACE(trace::Event::SYNC_TX, this, m_vv.size());
   }
 
+  expressSyncInterest(Name::Component(state));
+}
+
+void
+Logic::expressSyncInterest(const Name::Component& state)
+{
+  Name syncName(m_syncPrefix);
+  syncName.append(state);
+
   Interest interest(syncName, time::milliseconds(1000));
   interest.setCanBePrefix(true);
   interest.setMustBeFresh(true);
 
+  // Data packets ride in the parameters; reset interests carry no state
+  if (state != RESET_COMPONENT)
+  {
+    std::lock_guard<std::mutex> lock(m_inlineDataMutex);
+    if (!m_inlineData.empty())
+    {
+      Block inlineData(tlv::InlineData);
+      for (const auto& wire : m_inlineData)
+        inlineData.push_back(wire);
+      inlineData.encode();
+      interest.setApplicationParameters(inlineData);
+
+      m_metrics.inlineDataSent.increment(m_inlineData.size());
+      m_inlineData.clear();
+      m_inlineDataSize = 0;
+    }
+  }
+
   switch (m_securityOptions.interestSigningInfo.getSignerType())
   {
     case security::SigningInfo::SIGNER_TYPE_NULL:
-      interest.setName(syncName.appendNumber(0));
+      // With parameters, the digest component already follows the state
+      if (!interest.hasApplicationParameters())
+        interest.setName(syncName.appendNumber(0));
       break;
 
     case security::SigningInfo::SIGNER_TYPE_HMAC:
@@ -180,63 +411,227 @@ Logic::sendSyncInterest()
   }
 
   m_face.expressInterest(interest, nullptr, nullptr, nullptr);
+  m_metrics.syncInterestsSent.increment();
 }
 
 std::pair<bool, bool>
 Logic::mergeStateVector(const VersionVector &vvOther)
 {
-  std::lock_guard<std::mutex> lock(m_vvMutex);
+  bool myVectorNew = false;
+  bool otherVectorNew = false;
+  std::vector<MissingDataInfo> v;
 
-  bool myVectorNew = false,
-       otherVectorNew = false;
+  {
+    std::lock_guard<std::mutex> lock(m_vvMutex);
+    auto start = std::chrono::steady_clock::now();
 
-  // New data found in vvOther
-  std::vector<MissingDataInfo> v;
+    // New data found in vvOther
+    otherVectorNew = mergeEntries(vvOther, v);
+
+    // Check if I have newer state; both vectors are sorted by node ID,
+    // so walk them side by side instead of looking up every entry
+    auto other = vvOther.begin();
+    for (const auto& entry : m_vv)
+    {
+      while (other != vvOther.end() && other->first < entry.first)
+        ++other;
+
+      bool isInOther = other != vvOther.end() && other->first == entry.first;
+      SeqNo seqOther = isInOther ? other->second : 0;
+
+      if (seqOther < entry.second)
+      {
+        myVectorNew = true;
+        break;
+      }
+    }
+
+    m_metrics.vectorSize.set(m_vv.size());
+    m_metrics.mergeDuration.record(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start).count());
+  }
+
+  // Callback if missing data found, without the lock like the other merge paths
+  if (!v.empty())
+  {
+    m_onUpdate(v);
+  }
+
+  return std::make_pair(myVectorNew, otherVectorNew);
+}
+
+bool
+Logic::mergeEntries(const VersionVector &vvOther, std::vector<MissingDataInfo>& missing)
+{
+  bool otherVectorNew = false;
+
+  bool isPruning = m_inactivityTimeout > time::milliseconds::zero();
+  auto now = isPruning ? time::steady_clock::now() : time::steady_clock::TimePoint();
 
   // Check if other vector has newer state
-  for (auto entry : vvOther)
+  for (const auto& entry : vvOther)
   {
-    NodeID nidOther = entry.first;
+    const NodeID& nidOther = entry.first;
     SeqNo seqOther = entry.second;
     SeqNo seqCurrent = m_vv.get(nidOther);
 
     if (seqCurrent < seqOther)
     {
-      otherVectorNew = true;
+      SeqNo startSeq = seqCurrent + 1;
 
-      SeqNo startSeq = m_vv.get(nidOther) + 1;
-      v.push_back({nidOther, startSeq, seqOther});
+      if (!m_tombstones.empty())
+      {
+        auto tombstone = m_tombstones.find(nidOther);
+        if (tombstone != m_tombstones.end())
+        {
+          // Stale entry of a pruned member
+          if (seqOther <= tombstone->second.seq)
+            continue;
+
+          // The member is active again
+          startSeq = tombstone->second.seq + 1;
+          m_tombstones.erase(tombstone);
+          m_metrics.tombstones.set(m_tombstones.size());
+        }
+      }
+
+      otherVectorNew = true;
+      missing.push_back({nidOther, startSeq, seqOther});
 
       m_vv.set(nidOther, seqOther);
+      if (isPruning)
+        m_lastAdvance[nidOther] = now;
     }
   }
 
-  // Callback if missing data found
-  if (!v.empty())
+  return otherVectorNew;
+}
+
+void
+Logic::reset(bool isOnInterest)
+{
+  if (isOnInterest)
   {
-    m_onUpdate(v);
+    // A peer lost its state; announce ours unless someone else does first
+    {
+      std::lock_guard<std::mutex> lock(m_vvMutex);
+      std::fill(m_dirtyPartitions.begin(), m_dirtyPartitions.end(), true);
+    }
+    if (!m_recordedVv && !m_isSuppressingPartitions)
+      enterFullSync();
+    return;
+  }
+
+  m_recordedVv = nullptr;
+  m_isSuppressingPartitions = false;
+  m_isInSync = false;
+  cancelReconcile();
+  {
+    std::lock_guard<std::mutex> lock(m_vvMutex);
+    std::fill(m_dirtyPartitions.begin(), m_dirtyPartitions.end(), true);
   }
 
-  // Check if I have newer state
-  for (auto entry : m_vv)
+  expressSyncInterest(RESET_COMPONENT);
+  fetchRecoverySnapshot();
+  retxSyncInterest(false, 0);
+}
+
+void
+Logic::onRecoveryInterest(const Interest& interest)
+{
+  const auto& n = interest.getName();
+  auto now = time::steady_clock::now();
+
+  // Discovery of the latest snapshot, or a segment of a known one
+  bool isDiscovery = n.size() == m_syncPrefix.size() + 1;
+  if (isDiscovery &&
+      (m_recoverySegments.empty() || now - m_recoverySnapshotTime > RECOVERY_SNAPSHOT_LIFETIME))
   {
-    NodeID nid = entry.first;
-    SeqNo seq = entry.second;
-    SeqNo seqOther = vvOther.get(nid);
+    Block content;
+    {
+      std::lock_guard<std::mutex> lock(m_vvMutex);
+      content = m_vv.encode();
+    }
+
+    // Named under the node ID so that segments of different peers never mix
+    Name prefix(m_syncPrefix);
+    prefix.append(RECOVERY_COMPONENT).append(m_id).appendVersion();
 
-    if (seqOther < seq)
+    size_t nSegments = std::max<size_t>(1, (content.size() + RECOVERY_SEGMENT_SIZE - 1) /
+                                           RECOVERY_SEGMENT_SIZE);
+    auto finalBlockId = name::Component::fromSegment(nSegments - 1);
+
+    m_recoverySegments.clear();
+    for (size_t i = 0; i < nSegments; ++i)
     {
-      myVectorNew = true;
-      break;
+      size_t offset = i * RECOVERY_SEGMENT_SIZE;
+      auto data = make_shared<Data>(Name(prefix).appendSegment(i));
+      data->setContent(content.wire() + offset,
+                       std::min(RECOVERY_SEGMENT_SIZE, content.size() - offset));
+      data->setFreshnessPeriod(RECOVERY_SNAPSHOT_LIFETIME);
+      data->setFinalBlock(finalBlockId);
+      m_keyChain.sign(*data, m_securityOptions.dataSigningInfo);
+      m_recoverySegments.push_back(data);
     }
+    m_recoverySnapshotTime = now;
   }
 
-  return std::make_pair(myVectorNew, otherVectorNew);
+  if (m_recoverySegments.empty())
+    return;
+
+  const Name& snapshotName = m_recoverySegments.front()->getName();
+  size_t segment = 0;
+  if (!isDiscovery)
+  {
+    // Only serve segments of this node's own current snapshot (node ID and version)
+    if (n.size() != snapshotName.size() || !n.get(-1).isSegment() ||
+        n.getPrefix(-1) != snapshotName.getPrefix(-1))
+      return;
+    segment = n.get(-1).toSegment();
+  }
+
+  if (segment < m_recoverySegments.size())
+  {
+    m_face.put(*m_recoverySegments[segment]);
+    m_metrics.recoverySegmentsServed.increment();
+  }
 }
 
 void
-Logic::reset(bool isOnInterest)
+Logic::fetchRecoverySnapshot()
 {
+  if (m_recoveryFetcher)
+    m_recoveryFetcher->stop();
+
+  Interest interest(Name(m_syncPrefix).append(RECOVERY_COMPONENT));
+  interest.setCanBePrefix(true);
+  interest.setMustBeFresh(true);
+
+  auto& validator = static_cast<bool>(m_securityOptions.validator) ?
+                    *m_securityOptions.validator : security::getAcceptAllValidator();
+  m_recoveryFetcher = util::SegmentFetcher::start(m_face, interest, validator);
+
+  m_recoveryFetcher->onComplete.connect([this] (const ConstBufferPtr& content) {
+    m_recoveryFetcher.reset();
+
+    VersionVector vv;
+    try
+    {
+      vv = VersionVector(Block(content));
+    }
+    catch (const std::exception&)
+    {
+      return;
+    }
+
+    m_metrics.recoverySnapshotsFetched.increment();
+    if (mergeStateVector(vv).second)
+      m_timingPolicy->onActivity();
+  });
+
+  m_recoveryFetcher->onError.connect([this] (uint32_t, const std::string&) {
+    m_recoveryFetcher.reset();
+  });
 }
 
 SeqNo
@@ -257,10 +652,19 @@ Logic::updateSeqNo(const SeqNo& seq, const NodeID& nid)
     std::lock_guard<std::mutex> lock(m_vvMutex);
     prev = m_vv.get(t_nid);
     m_vv.set(t_nid, seq);
+    if (m_inactivityTimeout > time::milliseconds::zero() && seq > prev)
+      m_lastAdvance[t_nid] = time::steady_clock::now();
+    if (m_vv.getPartitionCount() > 1 && seq > prev)
+      m_dirtyPartitions[VersionVector::getPartition(t_nid, m_vv.getPartitionCount())] = true;
+    m_metrics.vectorSize.set(m_vv.size());
   }
 
   if (seq > prev)
+  {
+    m_isInSync = false;
+    m_timingPolicy->onActivity();
     retxSyncInterest(true, 0);
+  }
 }
 
 std::set<NodeID>
@@ -278,8 +682,367 @@ Logic::getSessionNames() const
 long
 Logic::getCurrentTime() const
 {
-  return std::chrono::duration_cast<std::chrono::microseconds>(
-    m_steadyClock.now().time_since_epoch()).count();
+  return time::duration_cast<time::microseconds>(
+    time::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t
+Logic::getGroupSize() const
+{
+  std::lock_guard<std::mutex> lock(m_vvMutex);
+  return m_vv.size();
+}
+
+void
+Logic::setPartitionCount(size_t count)
+{
+  std::lock_guard<std::mutex> lock(m_vvMutex);
+  m_vv.setPartitionCount(count);
+
+  // Announce all partitions once
+  m_dirtyPartitions.assign(m_vv.getPartitionCount() > 1 ? m_vv.getPartitionCount() : 0, true);
+}
+
+void
+Logic::onPartitionedState(const PartitionedState& state)
+{
+  NDN_SVS_TRACE(trace::Event::SYNC_RX, this, state.getPartitions().size());
+
+  bool myVectorNew = false,
+       otherVectorNew = false;
+  std::vector<MissingDataInfo> missing;
+
+  {
+    std::lock_guard<std::mutex> lock(m_vvMutex);
+    auto start = std::chrono::steady_clock::now();
+
+    for (const auto& partition : state.getPartitions())
+      otherVectorNew = mergeEntries(partition.second, missing) || otherVectorNew;
+
+    // Digests can only be compared with the same partitioning
+    if (state.getPartitionCount() == m_vv.getPartitionCount())
+    {
+      for (size_t p = 0; p < m_dirtyPartitions.size(); ++p)
+      {
+        if (m_vv.getPartitionDigest(p) == state.getDigests()[p])
+        {
+          // The peer has the same partition, which need not be sent by us
+          m_dirtyPartitions[p] = false;
+        }
+        else
+        {
+          // Either side may be newer; exchanging the partition resolves both
+          m_dirtyPartitions[p] = true;
+          myVectorNew = true;
+        }
+      }
+    }
+
+    m_metrics.vectorSize.set(m_vv.size());
+    m_metrics.mergeDuration.record(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start).count());
+  }
+
+  if (!missing.empty())
+    m_onUpdate(missing);
+
+  NDN_SVS_TRACE(trace::Event::MERGE_RESULT, this, myVectorNew, otherVectorNew);
+  if (myVectorNew || otherVectorNew)
+    m_timingPolicy->onActivity();
+
+  if (m_isSuppressingPartitions)
+  {
+    ++m_nRecorded;
+    m_metrics.syncInterestsSuppressed.increment();
+    NDN_SVS_TRACE(trace::Event::SYNC_SUPPRESSED, this);
+    return;
+  }
+
+  if (!myVectorNew)
+  {
+    retxSyncInterest(false, 0);
+    return;
+  }
+
+  m_isSuppressingPartitions = true;
+  m_nRecorded = 0;
+
+  int delay = m_timingPolicy->getSuppressionDelay(getGroupSize(), *m_rng).count();
+  NDN_SVS_TRACE(trace::Event::SUPPRESSION_ENTER, this, delay);
+  if (getCurrentTime() + delay * 1000 < m_nextSyncInterest)
+  {
+    retxSyncInterest(false, delay);
+  }
+}
+
+void
+Logic::onStateDigest(uint64_t digest)
+{
+  NDN_SVS_TRACE(trace::Event::SYNC_RX, this, 0);
+
+  bool isEqual;
+  {
+    std::lock_guard<std::mutex> lock(m_vvMutex);
+    isEqual = m_vv.getDigest() == digest;
+  }
+  NDN_SVS_TRACE(trace::Event::MERGE_RESULT, this, !isEqual, false);
+  m_isInSync = isEqual;
+
+  if (m_recordedVv)
+  {
+    // A digest adds nothing to the recorded state
+    ++m_nRecorded;
+    m_metrics.syncInterestsSuppressed.increment();
+    NDN_SVS_TRACE(trace::Event::SYNC_SUPPRESSED, this);
+    return;
+  }
+
+  if (isEqual)
+  {
+    retxSyncInterest(false, 0);
+    return;
+  }
+
+  m_metrics.syncDigestMismatches.increment();
+  m_timingPolicy->onActivity();
+
+  if (m_reconcileDifference > 0)
+    scheduleReconcile(InvertibleBloomFilter::getCellCount(m_reconcileDifference), nullptr);
+  else
+    enterFullSync();
+}
+
+void
+Logic::enterFullSync()
+{
+  // Either side may be newer. Recording an empty vector makes the full
+  // vector go out after suppression, unless a peer sends one that covers it.
+  m_isInSync = false;
+  enterSuppressionState(VersionVector());
+
+  int delay = m_timingPolicy->getSuppressionDelay(getGroupSize(), *m_rng).count();
+  NDN_SVS_TRACE(trace::Event::SUPPRESSION_ENTER, this, delay);
+  if (getCurrentTime() + delay * 1000 < m_nextSyncInterest)
+  {
+    retxSyncInterest(false, delay);
+  }
+}
+
+void
+Logic::onReconcile(const InvertibleBloomFilter* theirs, const VersionVector* received)
+{
+  bool isRequest = received == nullptr;
+  NDN_SVS_TRACE(trace::Event::SYNC_RX, this, received ? received->size() : 0);
+
+  std::vector<MissingDataInfo> missing;
+  bool otherVectorNew = false;
+  bool isDecoded = true;
+  bool hasTheirs = false;
+  VersionVector mine;
+
+  {
+    std::lock_guard<std::mutex> lock(m_vvMutex);
+
+    // Partial vectors can only add to the local state
+    if (received)
+      otherVectorNew = mergeEntries(*received, missing);
+
+    if (theirs)
+    {
+      InvertibleBloomFilter difference(theirs->getCellCount());
+      std::unordered_map<uint64_t, const NodeID*> nodeByHash;
+      for (const auto& entry : m_vv)
+      {
+        uint64_t hash = VersionVector::hashEntry(VersionVector::hashNode(entry.first), entry.second);
+        difference.insert(hash);
+        nodeByHash.emplace(hash, &entry.first);
+      }
+      difference.subtract(*theirs);
+
+      std::vector<uint64_t> positive, negative;
+      isDecoded = difference.decode(positive, negative);
+      if (isDecoded)
+      {
+        for (uint64_t hash : positive)
+        {
+          auto it = nodeByHash.find(hash);
+          if (it != nodeByHash.end())
+            mine.set(*it->second, m_vv.get(*it->second));
+        }
+        hasTheirs = !negative.empty();
+      }
+    }
+
+    m_metrics.vectorSize.set(m_vv.size());
+  }
+
+  if (!missing.empty())
+    m_onUpdate(missing);
+
+  // Whatever a peer already requested or sent need not be sent again
+  if (theirs && isRequest)
+    coverReconcile(VersionVector(), true);
+  if (received)
+    coverReconcile(*received, false);
+
+  NDN_SVS_TRACE(trace::Event::MERGE_RESULT, this, mine.size() > 0, otherVectorNew);
+  if (otherVectorNew)
+    m_timingPolicy->onActivity();
+
+  if (!theirs)
+    return;
+
+  if (!isDecoded)
+  {
+    m_metrics.reconcileFailures.increment();
+    enterFullSync();
+    return;
+  }
+
+  // Only a request is answered with a filter, which bounds the exchange
+  bool isSendingFilter = hasTheirs && isRequest;
+  if (mine.size() > 0 || isSendingFilter)
+    scheduleReconcile(isSendingFilter ? theirs->getCellCount() : 0, mine.size() > 0 ? &mine : nullptr);
+  else if (!hasTheirs)
+    m_isInSync = true;
+}
+
+void
+Logic::scheduleReconcile(size_t nCells, const VersionVector* entries)
+{
+  m_reconcileCells = std::max(m_reconcileCells, nCells);
+  if (entries != nullptr)
+  {
+    for (const auto& entry : *entries)
+    {
+      if (entry.second > m_reconcileEntries.get(entry.first))
+        m_reconcileEntries.set(entry.first, entry.second);
+    }
+  }
+
+  if (m_isReconcilePending)
+    return;
+
+  // Like a full vector, the answer waits for the suppression delay so that
+  // one overheard answer covers everybody's
+  m_isReconcilePending = true;
+  int delay = m_timingPolicy->getSuppressionDelay(getGroupSize(), *m_rng).count();
+  NDN_SVS_TRACE(trace::Event::SUPPRESSION_ENTER, this, delay);
+  m_reconcileEvent = m_scheduler.schedule(time::milliseconds(delay), [this] {
+    m_isReconcilePending = false;
+
+    // Send the latest sequence numbers of the pending entries
+    VersionVector entries;
+    {
+      std::lock_guard<std::mutex> lock(m_vvMutex);
+      for (const auto& entry : m_reconcileEntries)
+        entries.set(entry.first, std::max(entry.second, m_vv.get(entry.first)));
+    }
+    size_t nCells = m_reconcileCells;
+    m_reconcileCells = 0;
+    m_reconcileEntries = VersionVector();
+
+    sendReconcile(nCells, entries.size() > 0 ? &entries : nullptr);
+  });
+}
+
+void
+Logic::coverReconcile(const VersionVector& vvOther, bool coversRequest)
+{
+  if (!m_isReconcilePending)
+    return;
+
+  if (coversRequest)
+    m_reconcileCells = 0;
+
+  std::vector<NodeID> covered;
+  for (const auto& entry : m_reconcileEntries)
+  {
+    if (vvOther.get(entry.first) >= entry.second)
+      covered.push_back(entry.first);
+  }
+  for (const auto& nid : covered)
+    m_reconcileEntries.remove(nid);
+
+  if (m_reconcileCells == 0 && m_reconcileEntries.size() == 0)
+  {
+    cancelReconcile();
+    m_metrics.syncInterestsSuppressed.increment();
+    NDN_SVS_TRACE(trace::Event::SYNC_SUPPRESSED, this);
+  }
+}
+
+void
+Logic::cancelReconcile()
+{
+  m_reconcileEvent.cancel();
+  m_isReconcilePending = false;
+  m_reconcileCells = 0;
+  m_reconcileEntries = VersionVector();
+}
+
+void
+Logic::sendReconcile(size_t nCells, const VersionVector* entries)
+{
+  Block state(tlv::Reconcile);
+
+  if (nCells > 0)
+  {
+    InvertibleBloomFilter ibf(nCells);
+    std::lock_guard<std::mutex> lock(m_vvMutex);
+    for (const auto& entry : m_vv)
+      ibf.insert(VersionVector::hashEntry(VersionVector::hashNode(entry.first), entry.second));
+    state.push_back(ibf.encode());
+  }
+
+  if (entries != nullptr)
+    state.push_back(entries->encode());
+
+  state.encode();
+  NDN_SVS_TRACE(trace::Event::SYNC_TX, this, entries != nullptr ? entries->size() : 0);
+
+  expressSyncInterest(Name::Component(state));
+  m_metrics.reconcileSent.increment();
+}
+
+void
+Logic::pruneInactive()
+{
+  std::lock_guard<std::mutex> lock(m_vvMutex);
+  auto now = time::steady_clock::now();
+
+  for (auto it = m_tombstones.begin(); it != m_tombstones.end();)
+  {
+    if (it->second.expiry <= now)
+      it = m_tombstones.erase(it);
+    else
+      ++it;
+  }
+
+  for (const auto& entry : m_vv)
+  {
+    // Entries that never advanced since pruning was enabled start their period now
+    m_lastAdvance.emplace(entry.first, now);
+  }
+
+  auto cutoff = now - m_inactivityTimeout;
+  for (auto it = m_lastAdvance.begin(); it != m_lastAdvance.end();)
+  {
+    if (it->second > cutoff || it->first == m_id)
+    {
+      ++it;
+      continue;
+    }
+
+    auto expiry = now + m_inactivityTimeout * TOMBSTONE_LIFETIME_FACTOR;
+    m_tombstones[it->first] = {m_vv.get(it->first), expiry};
+    m_vv.remove(it->first);
+    m_metrics.entriesPruned.increment();
+    it = m_lastAdvance.erase(it);
+  }
+
+  m_metrics.vectorSize.set(m_vv.size());
+  m_metrics.tombstones.set(m_tombstones.size());
 }
 
 bool
@@ -289,9 +1052,9 @@ Logic::recordVector(const VersionVector &vvOther)
 
   std::lock_guard<std::mutex> lock(m_vvMutex);
 
-  for (auto entry : vvOther)
+  for (const auto& entry : vvOther)
   {
-    NodeID nidOther = entry.first;
+    const NodeID& nidOther = entry.first;
     SeqNo seqOther = entry.second;
     SeqNo seqCurrent = m_recordedVv->get(nidOther);
 
@@ -301,6 +1064,7 @@ Logic::recordVector(const VersionVector &vvOther)
     }
   }
 
+  ++m_nRecorded;
   return true;
 }
 
@@ -310,7 +1074,10 @@ Logic::enterSuppressionState(const VersionVector &vvOther)
   std::lock_guard<std::mutex> lock(m_vvMutex);
 
   if (!m_recordedVv)
+  {
     m_recordedVv = make_unique<VersionVector>(vvOther);
+    m_nRecorded = 0;
+  }
 }
 
 }  // namespace svs
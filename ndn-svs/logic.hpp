@@ -18,10 +18,16 @@
 #define NDN_SVS_LOGIC_HPP
 
 #include "common.hpp"
+#include "ibf.hpp"
+#include "metrics.hpp"
+#include "partitioned-state.hpp"
 #include "version-vector.hpp"
 #include "security-options.hpp"
+#include "timer-wheel.hpp"
+#include "timing-policy.hpp"
 
 #include <ndn-cxx/util/random.hpp>
+#include <ndn-cxx/util/segment-fetcher.hpp>
 
 #include <atomic>
 #include <chrono>
@@ -45,10 +51,19 @@ public:
  * @brief The callback function to handle state updates
  *
  * The parameter is a set of MissingDataInfo, of which each corresponds to
- * a session that has changed its state.
+ * a session that has changed its state. The callback is called without
+ * any lock of the logic held, so it may call back into the logic.
  */
 using UpdateCallback = function<void(const std::vector<MissingDataInfo>&)>;
 
+/**
+ * @brief The callback function to handle data packets carried in sync interests
+ *
+ * Called before the state of the sync interest is merged.
+ * The data is not validated.
+ */
+using InlineDataCallback = function<void(const Data&)>;
+
 /**
  * @brief Logic of SVS
  */
@@ -87,11 +102,49 @@ public:
   /**
    * @brief Reset the sync tree (and restart synchronization again)
    *
+   * A local reset drops any pending suppression, sends a reset interest
+   * asking peers to announce their full state, and fetches a recovery
+   * snapshot. A reset triggered by a peer's reset interest answers with
+   * the full local vector after the suppression delay.
+   *
    * @param isOnInterest a flag that tells whether the reset is called by reset interest.
    */
   void
   reset(bool isOnInterest = false);
 
+  /**
+   * @brief Fetch a recovery snapshot when joining the group
+   *
+   * Every node serves its full version vector as a signed, segmented
+   * snapshot under <sync-prefix>/recovery/<node-id>/<version>/<segment>.
+   * If enabled, a node fetches the snapshot of any peer once the sync
+   * prefix is registered, and merges it, which brings it to the full state without
+   * waiting for sync interests from all members. Disabled by default.
+   */
+  void
+  setRecoveryOnJoin(bool isEnabled)
+  {
+    m_isRecoveryOnJoin = isEnabled;
+  }
+
+  /**
+   * @brief Carry a data packet in the next sync interest
+   *
+   * The packet is sent once, in the ApplicationParameters of the next sync
+   * interest, so that peers get small payloads without fetching them.
+   * Packets beyond INLINE_DATA_BUDGET bytes per interest are not carried,
+   * and peers fetch them as usual.
+   */
+  void
+  addInlineData(const Data& data);
+
+  /// @brief Set the callback for data packets carried in received sync interests
+  void
+  setInlineDataCallback(const InlineDataCallback& onInlineData)
+  {
+    m_onInlineData = onInlineData;
+  }
+
   /**
    * @brief Get the node ID of the local session.
    *
@@ -143,6 +196,124 @@ public:
     return m_vv.toStr();
   }
 
+  /// @brief Get the runtime metrics of the sync logic
+  const LogicMetrics&
+  getMetrics() const
+  {
+    return m_metrics;
+  }
+
+  /// @brief Get the backend used for sync timers
+  TimerBackend&
+  getTimerBackend()
+  {
+    return *m_timers;
+  }
+
+  /**
+   * @brief Replace the backend used for sync timers
+   *
+   * Pending timers of the previous backend are dropped, and the
+   * next sync interest is rescheduled on the new backend.
+   */
+  void
+  setTimerBackend(std::unique_ptr<TimerBackend> timers);
+
+  /// @brief Set the policy deciding the timing of sync interests
+  void
+  setTimingPolicy(std::shared_ptr<TimingPolicy> timingPolicy)
+  {
+    m_timingPolicy = std::move(timingPolicy);
+  }
+
+  /**
+   * @brief Drop entries of members that have been inactive for a period
+   *
+   * An entry is removed from the version vector once its sequence number
+   * has not advanced for the given period; the entry of the local node is
+   * never removed. A tombstone then remembers the last sequence number for
+   * TOMBSTONE_LIFETIME_FACTOR times the period, so that peers which still
+   * carry the old entry cannot bring it back. A member that publishes again
+   * is added back, and the missing data since the tombstone is reported.
+   *
+   * All members of a group should use the same period.
+   *
+   * @param timeout Inactivity period, or zero to never prune (default)
+   */
+  void
+  setInactivityTimeout(const time::milliseconds& timeout)
+  {
+    m_inactivityTimeout = timeout;
+  }
+
+  /**
+   * @brief Shard the version vector into partitions for large groups
+   *
+   * Node IDs are hashed into the given number of partitions. Sync interests
+   * then carry a digest of every partition, plus the full entries of only
+   * those partitions that changed locally or were found to differ from a
+   * peer. Nodes that overhear the entries of a partition they were about
+   * to send drop it from their next sync interest.
+   *
+   * All members of a group must use the same count. Sync interests with
+   * plain version vectors are still accepted.
+   *
+   * @param count Number of partitions, or 1 to send full vectors (default)
+   */
+  void
+  setPartitionCount(size_t count);
+
+  /**
+   * @brief Send only a digest of the state while in sync with the group
+   *
+   * Once the last sync interest heard from a peer carried the same state as
+   * the local one, and nothing changed since, sync interests carry only a
+   * 64-bit digest of the version vector. A peer whose digest differs replies
+   * with its full vector after the suppression delay, which resolves the
+   * difference as usual.
+   *
+   * All members of a group must support digests. Has no effect in
+   * partitioned mode, where digests are always sent.
+   */
+  void
+  setDigestSync(bool isEnabled)
+  {
+    m_isDigestSync = isEnabled;
+  }
+
+  /**
+   * @brief Reconcile differing states with invertible Bloom filters
+   *
+   * Used with digest sync: a node that receives a digest different from
+   * its own replies with a filter of its entries, instead of the full vector
+   * after the suppression delay. Peers subtract their own filter, and send
+   * back only the entries that differ, plus their own filter if the request
+   * lacked entries they have. If the difference is too large to decode, the
+   * full vector is sent as usual.
+   *
+   * @param expectedDifference Number of differing entries the filters are
+   *        sized for, or 0 to disable (default)
+   */
+  void
+  setReconciliation(size_t expectedDifference)
+  {
+    m_reconcileDifference = expectedDifference;
+  }
+
+  /**
+   * @brief Use a private random engine with a fixed seed
+   *
+   * By default, timer jitter is drawn from the process-wide engine of ndn-cxx.
+   * Together with custom clocks (see ndn::time::setCustomClocks), seeding makes
+   * the behavior of the sync logic reproducible, e.g. for simulations.
+   */
+  void
+  seedRandom(uint32_t seed)
+  {
+    m_seededRng.seed(seed);
+    m_rng = &m_seededRng;
+  }
+
 NDN_SVS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   onSyncInterest(const Interest &interest);
@@ -168,6 +339,22 @@ NDN_SVS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   sendSyncInterest();
 
+  /// @brief Send a sync interest carrying the given state component
+  void
+  expressSyncInterest(const Name::Component& state);
+
+  /// @brief Pass the data packets carried in a sync interest to the callback
+  void
+  onInlineData(const Interest& interest);
+
+  /// @brief Serve a segment of the recovery snapshot
+  void
+  onRecoveryInterest(const Interest& interest);
+
+  /// @brief Fetch and merge the recovery snapshot of any peer
+  void
+  fetchRecoverySnapshot();
+
   /**
    * @brief Merge state vector into the current
    *
@@ -181,6 +368,76 @@ NDN_SVS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   std::pair<bool, bool>
   mergeStateVector(const VersionVector &vvOther);
 
+  /**
+   * @brief Merge newer entries of vvOther into the current vector
+   *
+   * Must be called with m_vvMutex held. Unlike mergeStateVector, entries
+   * missing from vvOther are not compared, so vvOther may be partial.
+   *
+   * @param vvOther state vector to merge in
+   * @param missing receives the new data found in vvOther
+   * @returns whether vvOther had newer entries
+   */
+  bool
+  mergeEntries(const VersionVector &vvOther, std::vector<MissingDataInfo>& missing);
+
+  /// @brief Handle a sync interest carrying partition digests
+  void
+  onPartitionedState(const PartitionedState& state);
+
+  /// @brief Handle a sync interest carrying only a state digest
+  void
+  onStateDigest(uint64_t digest);
+
+  /**
+   * @brief Handle a sync interest carrying a filter and/or partial vector
+   *
+   * @param theirs Filter of the sender's state, or nullptr for none
+   * @param received Entries sent, or nullptr for a request
+   */
+  void
+  onReconcile(const InvertibleBloomFilter* theirs, const VersionVector* received);
+
+  /**
+   * @brief Send a reconciliation message
+   *
+   * @param nCells Size of the filter of the local state to include, or 0 for none
+   * @param entries Entries to include, or nullptr for none
+   */
+  void
+  sendReconcile(size_t nCells, const VersionVector* entries);
+
+  /**
+   * @brief Send a reconciliation message after the suppression delay
+   *
+   * Filters and entries of calls made before the message goes out are
+   * merged into it.
+   *
+   * @param nCells Size of the filter of the local state to include, or 0 for none
+   * @param entries Entries to include, or nullptr for none
+   */
+  void
+  scheduleReconcile(size_t nCells, const VersionVector* entries);
+
+  /**
+   * @brief Drop what an overheard message covers from the pending reconciliation
+   *
+   * @param vvOther Entries sent by a peer
+   * @param coversRequest Whether the message also covers a pending filter
+   */
+  void
+  coverReconcile(const VersionVector& vvOther, bool coversRequest);
+
+  /// @brief Drop the pending reconciliation message
+  void
+  cancelReconcile();
+
+  /**
+   * @brief Answer a differing state by sending the full vector after suppression
+   */
+  void
+  enterFullSync();
+
   /**
    * @brief Record vector by merging it into m_recordedVv
    *
@@ -208,12 +465,35 @@ NDN_SVS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
     return m_scheduler;
   }
 
-  /// @brief Get the current time in microseconds with arbitrary reference
+  /**
+   * @brief Get the current time in microseconds with arbitrary reference
+   *
+   * Follows ndn::time::steady_clock, so that custom clocks apply.
+   */
   long
   getCurrentTime() const;
 
+  /// @brief Get the number of nodes in the version vector
+  size_t
+  getGroupSize() const;
+
+  /**
+   * @brief Remove inactive entries and expired tombstones
+   *
+   * Called before sending a sync interest if an inactivity timeout is set.
+   */
+  void
+  pruneInactive();
+
 public:
   static const NodeID EMPTY_NODE_ID;
+  static constexpr int TOMBSTONE_LIFETIME_FACTOR = 4;
+  /// @brief Payload size of a recovery snapshot segment
+  static constexpr size_t RECOVERY_SEGMENT_SIZE = 8000;
+  /// @brief How long a recovery snapshot is served before it is rebuilt
+  static const time::milliseconds RECOVERY_SNAPSHOT_LIFETIME;
+  /// @brief Maximum size of the data packets carried in one sync interest
+  static constexpr size_t INLINE_DATA_BUDGET = 4000;
 
 private:
   static const ConstBufferPtr EMPTY_DIGEST;
@@ -228,6 +508,7 @@ private:
   ndn::ScopedRegisteredPrefixHandle m_syncRegisteredPrefix;
 
   const UpdateCallback m_onUpdate;
+  InlineDataCallback m_onInlineData;
 
   // State
   VersionVector m_vv;
@@ -235,28 +516,65 @@ private:
   // Aggregates incoming vectors while in suppression state
   std::unique_ptr<VersionVector> m_recordedVv = nullptr;
 
+  // Pruning of inactive entries
+  struct Tombstone
+  {
+    SeqNo seq;
+    time::steady_clock::TimePoint expiry;
+  };
+  time::milliseconds m_inactivityTimeout = time::milliseconds::zero();
+  std::map<NodeID, time::steady_clock::TimePoint> m_lastAdvance;
+  std::map<NodeID, Tombstone> m_tombstones;
+
+  // Partitioned mode: partitions to include in the next sync interest
+  std::vector<bool> m_dirtyPartitions;
+  bool m_isSuppressingPartitions = false;
+
+  // Digest sync: whether the last state heard from a peer equals ours
+  bool m_isDigestSync = false;
+  std::atomic_bool m_isInSync{false};
+  size_t m_reconcileDifference = 0;
+  // Reconciliation message waiting for the suppression delay
+  bool m_isReconcilePending = false;
+  size_t m_reconcileCells = 0;
+  VersionVector m_reconcileEntries;
+
+  // Recovery snapshots
+  bool m_isRecoveryOnJoin = false;
+  std::vector<shared_ptr<Data>> m_recoverySegments;
+  time::steady_clock::TimePoint m_recoverySnapshotTime;
+  shared_ptr<util::SegmentFetcher> m_recoveryFetcher;
+
+  // Data packets to carry in the next sync interest
+  std::vector<Block> m_inlineData;
+  size_t m_inlineDataSize = 0;
+  std::mutex m_inlineDataMutex;
+
   // Random Engine
-  ndn::random::RandomNumberEngine& m_rng;
+  ndn::random::RandomNumberEngine* m_rng;
+  ndn::random::RandomNumberEngine m_seededRng;
   // Milliseconds between sending two packets in the queues
   std::uniform_int_distribution<> m_packetDist;
-  // Milliseconds between sending two sync interests
-  std::uniform_int_distribution<> m_retxDist;
-  // Milliseconds to send sync interest reply after
-  std::uniform_int_distribution<> m_intrReplyDist;
+  // Periods of sync interests and replies
+  std::shared_ptr<TimingPolicy> m_timingPolicy;
+  // Number of sync interests recorded in the current suppression window
+  size_t m_nRecorded = 0;
 
   // Security
   ndn::KeyChain& m_keyChain;
   ndn::KeyChain m_keyChainMem;
 
   ndn::Scheduler m_scheduler;
-  scheduler::ScopedEventId m_retxEvent;
+  std::unique_ptr<TimerBackend> m_timers;
+  TimerBackend::TimerId m_retxEvent = TimerBackend::INVALID_TIMER;
   scheduler::ScopedEventId m_packetEvent;
-
-  std::chrono::steady_clock m_steadyClock;
+  scheduler::ScopedEventId m_reconcileEvent;
 
   // Time at which the next sync interest will be sent
   std::atomic_long m_nextSyncInterest;
 
+  LogicMetrics m_metrics;
+
   int m_instanceId;
   static int s_instanceCounter;
 };
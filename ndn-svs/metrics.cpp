@@ -0,0 +1,157 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "metrics.hpp"
+
+#include <sstream>
+
+namespace ndn {
+namespace svs {
+
+constexpr size_t Histogram::N_BUCKETS;
+
+void
+Histogram::record(uint64_t value)
+{
+  size_t bucket = value == 0 ? 0 : 64 - __builtin_clzll(value);
+  if (bucket >= N_BUCKETS)
+    bucket = N_BUCKETS - 1;
+
+  m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot
+Histogram::snapshot() const
+{
+  Snapshot s;
+  for (size_t i = 0; i < N_BUCKETS; ++i)
+    s.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+  s.count = m_count.load(std::memory_order_relaxed);
+  s.sum = m_sum.load(std::memory_order_relaxed);
+  return s;
+}
+
+uint64_t
+Histogram::Snapshot::quantile(double q) const
+{
+  uint64_t total = 0;
+  for (auto n : buckets)
+    total += n;
+  if (total == 0)
+    return 0;
+
+  uint64_t rank = static_cast<uint64_t>(q * total);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < N_BUCKETS; ++i)
+  {
+    seen += buckets[i];
+    if (seen > rank)
+      return getBucketBound(i);
+  }
+  return getBucketBound(N_BUCKETS - 1);
+}
+
+std::string
+MetricsSnapshot::toStr(const std::string& prefix) const
+{
+  std::ostringstream stream;
+
+  for (const auto& counter : counters)
+  {
+    stream << "# TYPE " << prefix << counter.first << " counter\n";
+    stream << prefix << counter.first << " " << counter.second << "\n";
+  }
+
+  for (const auto& gauge : gauges)
+  {
+    stream << "# TYPE " << prefix << gauge.first << " gauge\n";
+    stream << prefix << gauge.first << " " << gauge.second << "\n";
+  }
+
+  for (const auto& histogram : histograms)
+  {
+    const std::string name = prefix + histogram.first;
+    const auto& h = histogram.second;
+
+    stream << "# TYPE " << name << " histogram\n";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < Histogram::N_BUCKETS; ++i)
+    {
+      cumulative += h.buckets[i];
+      // Skip the empty tail
+      if (cumulative == h.count && h.buckets[i] == 0)
+        continue;
+      stream << name << "_bucket{le=\"" << Histogram::getBucketBound(i) - 1 << "\"} "
+             << cumulative << "\n";
+    }
+    stream << name << "_bucket{le=\"+Inf\"} " << h.count << "\n";
+    stream << name << "_sum " << h.sum << "\n";
+    stream << name << "_count " << h.count << "\n";
+  }
+
+  return stream.str();
+}
+
+void
+LogicMetrics::snapshot(MetricsSnapshot& out) const
+{
+  out.counters["sync_interests_sent"] = syncInterestsSent.get();
+  out.counters["sync_interests_received"] = syncInterestsReceived.get();
+  out.counters["sync_interests_suppressed"] = syncInterestsSuppressed.get();
+  out.counters["sync_interests_rejected"] = syncInterestsRejected.get();
+  out.counters["sync_interests_malformed"] = syncInterestsMalformed.get();
+  out.counters["sync_digests_sent"] = syncDigestsSent.get();
+  out.counters["sync_digest_mismatches"] = syncDigestMismatches.get();
+  out.counters["reconcile_sent"] = reconcileSent.get();
+  out.counters["reconcile_failures"] = reconcileFailures.get();
+  out.counters["recovery_segments_served"] = recoverySegmentsServed.get();
+  out.counters["recovery_snapshots_fetched"] = recoverySnapshotsFetched.get();
+  out.counters["inline_data_sent"] = inlineDataSent.get();
+  out.counters["inline_data_received"] = inlineDataReceived.get();
+  out.counters["entries_pruned"] = entriesPruned.get();
+  out.gauges["vector_size"] = vectorSize.get();
+  out.gauges["tombstones"] = tombstones.get();
+  out.histograms["merge_duration_us"] = mergeDuration.snapshot();
+}
+
+void
+SocketMetrics::snapshot(MetricsSnapshot& out) const
+{
+  out.counters["data_published"] = dataPublished.get();
+  out.counters["data_interests_received"] = dataInterestsReceived.get();
+  out.counters["data_interests_satisfied"] = dataInterestsSatisfied.get();
+  out.counters["replies_suppressed"] = repliesSuppressed.get();
+  out.counters["fetch_store_hits"] = fetchStoreHits.get();
+  out.counters["fetch_interests_sent"] = fetchInterestsSent.get();
+  out.counters["fetch_retries"] = fetchRetries.get();
+  out.counters["fetch_timeouts"] = fetchTimeouts.get();
+  out.counters["fetch_validated"] = fetchValidated.get();
+  out.counters["fetch_validation_failed"] = fetchValidationFailed.get();
+  out.counters["subscription_data"] = subscriptionData.get();
+  out.counters["updates_trimmed"] = updatesTrimmed.get();
+  out.counters["snapshots_published"] = snapshotsPublished.get();
+  out.counters["snapshots_fetched"] = snapshotsFetched.get();
+  out.counters["store_inserts"] = storeInserts.get();
+  out.counters["cache_evictions"] = cacheEvictions.get();
+  out.counters["gaps_refetched"] = gapsRefetched.get();
+  out.counters["delivery_skipped"] = deliverySkipped.get();
+  out.histograms["fetch_latency_us"] = fetchLatency.snapshot();
+}
+
+}  // namespace svs
+}  // namespace ndn
@@ -0,0 +1,245 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_METRICS_HPP
+#define NDN_SVS_METRICS_HPP
+
+#include "common.hpp"
+
+#include <array>
+#include <atomic>
+#include <map>
+
+namespace ndn {
+namespace svs {
+
+/**
+ * @brief Monotonic counter that can be updated and read from any thread
+ */
+class Counter : noncopyable
+{
+public:
+  void
+  increment(uint64_t n = 1)
+  {
+    m_value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  uint64_t
+  get() const
+  {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint64_t> m_value{0};
+};
+
+/**
+ * @brief Instantaneous value that can be updated and read from any thread
+ */
+class Gauge : noncopyable
+{
+public:
+  void
+  set(int64_t value)
+  {
+    m_value.store(value, std::memory_order_relaxed);
+  }
+
+  void
+  add(int64_t n)
+  {
+    m_value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  int64_t
+  get() const
+  {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<int64_t> m_value{0};
+};
+
+/**
+ * @brief Histogram with power-of-two buckets
+ *
+ * Bucket 0 counts zero values and bucket i counts values in [2^(i-1), 2^i).
+ * Recording a value is a few relaxed atomic increments.
+ */
+class Histogram : noncopyable
+{
+public:
+  static constexpr size_t N_BUCKETS = 40;
+
+  struct Snapshot
+  {
+    std::array<uint64_t, N_BUCKETS> buckets{};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+
+    /**
+     * @brief Estimate a quantile
+     * @param q Quantile in [0, 1]
+     * @returns the upper bound of the bucket containing the quantile
+     */
+    uint64_t
+    quantile(double q) const;
+
+    double
+    mean() const
+    {
+      return count == 0 ? 0 : double(sum) / count;
+    }
+  };
+
+  void
+  record(uint64_t value);
+
+  Snapshot
+  snapshot() const;
+
+  /// @brief Get the upper bound (exclusive) of a bucket
+  static uint64_t
+  getBucketBound(size_t bucket)
+  {
+    return uint64_t(1) << bucket;
+  }
+
+private:
+  std::array<std::atomic<uint64_t>, N_BUCKETS> m_buckets{};
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<uint64_t> m_sum{0};
+};
+
+/**
+ * @brief Point-in-time copy of a set of metrics
+ */
+struct MetricsSnapshot
+{
+  std::map<std::string, uint64_t> counters;
+  std::map<std::string, int64_t> gauges;
+  std::map<std::string, Histogram::Snapshot> histograms;
+
+  /**
+   * @brief Get a text representation, one metric per line
+   *
+   * The output follows the Prometheus text exposition format.
+   */
+  std::string
+  toStr(const std::string& prefix = "svs_") const;
+};
+
+/**
+ * @brief Metrics of the sync logic
+ */
+struct LogicMetrics : noncopyable
+{
+  /** Sync interests sent */
+  Counter syncInterestsSent;
+  /** Sync interests received and validated */
+  Counter syncInterestsReceived;
+  /** Sync interests recorded while in suppression state */
+  Counter syncInterestsSuppressed;
+  /** Sync interests that failed validation */
+  Counter syncInterestsRejected;
+  /** Sync interests that could not be decoded */
+  Counter syncInterestsMalformed;
+  /** Sync interests sent with only the state digest */
+  Counter syncDigestsSent;
+  /** Received state digests that differed from the local one */
+  Counter syncDigestMismatches;
+  /** Reconciliation messages sent */
+  Counter reconcileSent;
+  /** Received filters whose difference could not be decoded */
+  Counter reconcileFailures;
+  /** Recovery snapshot segments served to peers */
+  Counter recoverySegmentsServed;
+  /** Recovery snapshots fetched and merged */
+  Counter recoverySnapshotsFetched;
+  /** Data packets carried in sent sync interests */
+  Counter inlineDataSent;
+  /** Data packets carried in received sync interests */
+  Counter inlineDataReceived;
+  /** Inactive entries removed from the version vector */
+  Counter entriesPruned;
+  /** Number of entries in the version vector */
+  Gauge vectorSize;
+  /** Number of tombstones of pruned entries */
+  Gauge tombstones;
+  /** Duration of merging a received state vector, in microseconds */
+  Histogram mergeDuration;
+
+  /// @brief Add the current values to a snapshot
+  void
+  snapshot(MetricsSnapshot& out) const;
+};
+
+/**
+ * @brief Metrics of data publishing and fetching
+ */
+struct SocketMetrics : noncopyable
+{
+  /** Data packets published */
+  Counter dataPublished;
+  /** Data interests received */
+  Counter dataInterestsReceived;
+  /** Data interests answered from the data store */
+  Counter dataInterestsSatisfied;
+  /** Delayed replies dropped because another node answered first */
+  Counter repliesSuppressed;
+  /** Fetches answered from the local data store */
+  Counter fetchStoreHits;
+  /** Data interests expressed, including retries */
+  Counter fetchInterestsSent;
+  /** Data interests retried after a timeout or nack */
+  Counter fetchRetries;
+  /** Fetches that failed after all retries */
+  Counter fetchTimeouts;
+  /** Fetched data packets that passed validation */
+  Counter fetchValidated;
+  /** Fetched data packets that failed validation */
+  Counter fetchValidationFailed;
+  /** Data packets delivered through subscriptions */
+  Counter subscriptionData;
+  /** SeqNos dropped from updates by the latest count or time horizon */
+  Counter updatesTrimmed;
+  /** Snapshots published */
+  Counter snapshotsPublished;
+  /** Snapshots fetched and validated */
+  Counter snapshotsFetched;
+  /** Data packets inserted in the data store by the socket, not counting names it already held */
+  Counter storeInserts;
+  /** Cached packets evicted by the cache policy */
+  Counter cacheEvictions;
+  /** SeqNos fetched again by the delivery tracking after a failed fetch */
+  Counter gapsRefetched;
+  /** SeqNos given up on by the delivery tracking after failed fetches or a head-of-line timeout */
+  Counter deliverySkipped;
+  /** Time from the first interest of a fetch to the validated data, in microseconds */
+  Histogram fetchLatency;
+
+  /// @brief Add the current values to a snapshot
+  void
+  snapshot(MetricsSnapshot& out) const;
+};
+
+}  // namespace svs
+}  // namespace ndn
+
+#endif // NDN_SVS_METRICS_HPP
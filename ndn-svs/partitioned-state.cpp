@@ -0,0 +1,113 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "partitioned-state.hpp"
+#include "tlv.hpp"
+
+namespace ndn {
+namespace svs {
+
+PartitionedState::PartitionedState(const VersionVector& vv, const std::vector<size_t>& partitions)
+{
+  m_digests.reserve(vv.getPartitionCount());
+  for (size_t p = 0; p < vv.getPartitionCount(); ++p)
+    m_digests.push_back(vv.getPartitionDigest(p));
+
+  for (size_t p : partitions)
+    m_partitions.emplace(p, vv.getPartitionEntries(p));
+}
+
+PartitionedState::PartitionedState(const ndn::Block& block)
+{
+  if (block.type() != tlv::PartitionedState)
+    NDN_THROW(Error("Expected PartitionedState"));
+  block.parse();
+
+  auto it = block.elements_begin();
+  if (it == block.elements_end() || it->type() != tlv::PartitionDigests)
+    NDN_THROW(Error("Expected PartitionDigests"));
+  if (it->value_size() == 0 || it->value_size() % 8 != 0)
+    NDN_THROW(Error("Invalid PartitionDigests length"));
+
+  const uint8_t* value = it->value();
+  for (size_t i = 0; i < it->value_size(); i += 8)
+  {
+    uint64_t digest = 0;
+    for (size_t j = 0; j < 8; ++j)
+      digest = (digest << 8) | value[i + j];
+    m_digests.push_back(digest);
+  }
+
+  for (++it; it != block.elements_end(); ++it)
+  {
+    if (it->type() != tlv::Partition)
+      NDN_THROW(Error("Expected Partition"));
+    it->parse();
+
+    if (it->elements_size() != 2 ||
+        it->elements()[0].type() != tlv::PartitionIndex ||
+        it->elements()[1].type() != tlv::VersionVector)
+      NDN_THROW(Error("Expected PartitionIndex and VersionVector"));
+
+    size_t index = ndn::encoding::readNonNegativeInteger(it->elements()[0]);
+    if (index >= m_digests.size())
+      NDN_THROW(Error("PartitionIndex out of range"));
+
+    try
+    {
+      m_partitions[index] = VersionVector(it->elements()[1]);
+    }
+    catch (const VersionVector::Error& e)
+    {
+      NDN_THROW_NESTED(Error(e.what()));
+    }
+  }
+}
+
+ndn::Block
+PartitionedState::encode() const
+{
+  ndn::encoding::Encoder enc;
+
+  size_t totalLength = 0;
+
+  for (auto it = m_partitions.rbegin(); it != m_partitions.rend(); it++)
+  {
+    size_t partitionLength = enc.prependBlock(it->second.encode());
+    partitionLength += ndn::encoding::prependNonNegativeIntegerBlock(enc, tlv::PartitionIndex,
+                                                                     it->first);
+    partitionLength += enc.prependVarNumber(partitionLength);
+    partitionLength += enc.prependVarNumber(tlv::Partition);
+    totalLength += partitionLength;
+  }
+
+  std::vector<uint8_t> digests;
+  digests.reserve(m_digests.size() * 8);
+  for (uint64_t digest : m_digests)
+  {
+    for (int shift = 56; shift >= 0; shift -= 8)
+      digests.push_back(static_cast<uint8_t>(digest >> shift));
+  }
+  totalLength += enc.prependByteArrayBlock(tlv::PartitionDigests, digests.data(), digests.size());
+
+  totalLength += enc.prependVarNumber(totalLength);
+  totalLength += enc.prependVarNumber(tlv::PartitionedState);
+
+  return enc.block();
+}
+
+} // namespace svs
+} // namespace ndn
@@ -0,0 +1,98 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_PARTITIONED_STATE_HPP
+#define NDN_SVS_PARTITIONED_STATE_HPP
+
+#include "version-vector.hpp"
+
+namespace ndn {
+namespace svs {
+
+/**
+ * @brief State carried by sync interests in partitioned mode
+ *
+ * Holds the digest of every partition of the sender's version vector,
+ * and the entries of a subset of the partitions.
+ *
+ *   PartitionedState = PARTITIONED-STATE-TYPE TLV-LENGTH
+ *                        PartitionDigests
+ *                        *Partition
+ *   PartitionDigests = PARTITION-DIGESTS-TYPE TLV-LENGTH
+ *                        *8OCTET ; one big-endian digest per partition
+ *   Partition = PARTITION-TYPE TLV-LENGTH
+ *                 PartitionIndex
+ *                 VersionVector
+ */
+class PartitionedState
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+public:
+  PartitionedState() = default;
+
+  /**
+   * @brief Summarize a partitioned version vector
+   *
+   * @param vv Vector with a partition count greater than one
+   * @param partitions Partitions whose entries are included
+   */
+  PartitionedState(const VersionVector& vv, const std::vector<size_t>& partitions);
+
+  /** Decode from a PartitionedState block */
+  explicit
+  PartitionedState(const ndn::Block& block);
+
+  ndn::Block
+  encode() const;
+
+  size_t
+  getPartitionCount() const
+  {
+    return m_digests.size();
+  }
+
+  const std::vector<uint64_t>&
+  getDigests() const
+  {
+    return m_digests;
+  }
+
+  /// @brief Get the included partitions, by index
+  const std::map<size_t, VersionVector>&
+  getPartitions() const
+  {
+    return m_partitions;
+  }
+
+private:
+  std::vector<uint64_t> m_digests;
+  std::map<size_t, VersionVector> m_partitions;
+};
+
+} // namespace svs
+} // namespace ndn
+
+#endif // NDN_SVS_PARTITIONED_STATE_HPP
@@ -0,0 +1,104 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "reorder-buffer.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace svs {
+
+ReorderBuffer::ReorderBuffer(size_t capacity, SeqNo next)
+  : m_slots(std::max<size_t>(capacity, 1))
+  , m_next(next)
+{
+}
+
+bool
+ReorderBuffer::has(const SeqNo& seq) const
+{
+  return isInWindow(seq) && m_slots[seq % m_slots.size()] != nullptr;
+}
+
+bool
+ReorderBuffer::insert(const SeqNo& seq, const Data& data)
+{
+  if (!isInWindow(seq) || has(seq))
+    return false;
+
+  slot(seq) = make_shared<Data>(data);
+  ++m_size;
+  return true;
+}
+
+size_t
+ReorderBuffer::release(const ReleaseCallback& onRelease)
+{
+  size_t nReleased = 0;
+  while (m_size > 0 && slot(m_next) != nullptr)
+  {
+    // Take the packet out first, the callback may use the buffer
+    shared_ptr<const Data> data = std::move(slot(m_next));
+    slot(m_next) = nullptr;
+    --m_size;
+    SeqNo seq = m_next++;
+
+    onRelease(seq, *data);
+    ++nReleased;
+  }
+  return nReleased;
+}
+
+void
+ReorderBuffer::skipTo(const SeqNo& seq)
+{
+  if (seq <= m_next)
+    return;
+
+  if (seq - m_next >= m_slots.size())
+  {
+    std::fill(m_slots.begin(), m_slots.end(), nullptr);
+    m_size = 0;
+    m_next = seq;
+    return;
+  }
+
+  for (; m_next < seq; ++m_next)
+  {
+    auto& data = slot(m_next);
+    if (data != nullptr)
+    {
+      data = nullptr;
+      --m_size;
+    }
+  }
+}
+
+SeqNo
+ReorderBuffer::getFirst() const
+{
+  if (m_size == 0)
+    return 0;
+
+  for (SeqNo seq = m_next; ; ++seq)
+  {
+    if (m_slots[seq % m_slots.size()] != nullptr)
+      return seq;
+  }
+}
+
+}  // namespace svs
+}  // namespace ndn
@@ -0,0 +1,117 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_REORDER_BUFFER_HPP
+#define NDN_SVS_REORDER_BUFFER_HPP
+
+#include "common.hpp"
+
+#include <vector>
+
+namespace ndn {
+namespace svs {
+
+/**
+ * @brief Bounded buffer putting the data packets of one node in seqNo order
+ *
+ * Packets are accepted within a window of getCapacity() seqNos starting
+ * at the next seqNo expected, and kept in a ring of that many slots, so
+ * that the memory used is fixed. Packets are released in runs of
+ * consecutive seqNos from the next one expected.
+ */
+class ReorderBuffer : noncopyable
+{
+public:
+  using ReleaseCallback = function<void(const SeqNo& seq, const Data& data)>;
+
+  /**
+   * @param capacity Number of slots, at least 1
+   * @param next The first seqNo expected
+   */
+  explicit
+  ReorderBuffer(size_t capacity, SeqNo next = 1);
+
+  /// @brief Whether a seqNo is within the window of the buffer
+  bool
+  isInWindow(const SeqNo& seq) const
+  {
+    return seq >= m_next && seq - m_next < m_slots.size();
+  }
+
+  /// @brief Whether a packet is held for a seqNo
+  bool
+  has(const SeqNo& seq) const;
+
+  /**
+   * @brief Hold a packet until the seqNos before it are released or skipped
+   *
+   * @return false if the seqNo is outside the window or already held
+   */
+  bool
+  insert(const SeqNo& seq, const Data& data);
+
+  /**
+   * @brief Release the packets held for the next seqNos expected
+   *
+   * @return the number of packets released
+   */
+  size_t
+  release(const ReleaseCallback& onRelease);
+
+  /// @brief Stop waiting for the seqNos below @p seq, dropping their packets
+  void
+  skipTo(const SeqNo& seq);
+
+  /// @brief Lowest seqNo held, 0 if the buffer is empty
+  SeqNo
+  getFirst() const;
+
+  SeqNo
+  getNext() const
+  {
+    return m_next;
+  }
+
+  size_t
+  getCapacity() const
+  {
+    return m_slots.size();
+  }
+
+  /// @brief Number of packets held
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+private:
+  shared_ptr<const Data>&
+  slot(const SeqNo& seq)
+  {
+    return m_slots[seq % m_slots.size()];
+  }
+
+private:
+  std::vector<shared_ptr<const Data>> m_slots;
+  SeqNo m_next;
+  size_t m_size = 0;
+};
+
+}  // namespace svs
+}  // namespace ndn
+
+#endif // NDN_SVS_REORDER_BUFFER_HPP
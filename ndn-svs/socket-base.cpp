@@ -16,14 +16,28 @@
 
 #include "socket-base.hpp"
 #include "store-memory.hpp"
+#include "trace.hpp"
 
 #include <ndn-cxx/security/signing-helpers.hpp>
 
+#include <cmath>
+
 namespace ndn {
 namespace svs {
 
 const NodeID SocketBase::EMPTY_NODE_ID;
 const std::shared_ptr<DataStore> SocketBase::DEFAULT_DATASTORE;
+const name::Component SocketBase::SNAPSHOT_COMPONENT("snapshot");
+const time::milliseconds SocketBase::DEFAULT_SUBSCRIPTION_LIFETIME(10000);
+const time::milliseconds SocketBase::DEFAULT_GAP_RETRY_INTERVAL(1000);
+constexpr size_t SocketBase::DEFAULT_MAX_FETCH_ATTEMPTS;
+
+// Delay before re-arming a subscription after a Nack
+static const time::milliseconds SUBSCRIPTION_RETRY_DELAY(1000);
+// Maximum number of interests held for data not yet published
+static constexpr size_t MAX_PENDING_INTERESTS = 1000;
+// Maximum number of cached data name prefixes
+static constexpr size_t MAX_DATA_PREFIXES = 10000;
 
 SocketBase::SocketBase(const Name& syncPrefix,
                        const Name& dataPrefix,
@@ -39,12 +53,16 @@ SocketBase::SocketBase(const Name& syncPrefix,
   , m_face(face)
   , m_onUpdate(updateCallback)
   , m_dataStore(dataStore)
-  , m_logic(m_face, m_keyChain, m_syncPrefix, m_onUpdate, securityOptions, m_id)
+  , m_scheduler(m_face.getIoService())
+  , m_logic(m_face, m_keyChain, m_syncPrefix, bind(&SocketBase::onUpdate, this, _1),
+            securityOptions, m_id)
 {
   // Register new data store
   if (m_dataStore == DEFAULT_DATASTORE)
     m_dataStore = make_shared<MemoryDataStore>();
 
+  m_logic.setInlineDataCallback(bind(&SocketBase::onInlineData, this, _1));
+
   // Register data prefix
   m_registeredDataPrefix =
     m_face.setInterestFilter(m_dataPrefix,
@@ -54,14 +72,14 @@ SocketBase::SocketBase(const Name& syncPrefix,
 
 void
 SocketBase::publishData(const uint8_t* buf, size_t len, const ndn::time::milliseconds& freshness,
-                        const NodeID id)
+                        const NodeID& id)
 {
   publishData(ndn::encoding::makeBinaryBlock(ndn::tlv::Content, buf, len), freshness, id);
 }
 
 void
 SocketBase::publishData(const Block& content, const ndn::time::milliseconds& freshness,
-                        const NodeID id)
+                        const NodeID& id)
 {
   NodeID pubId = id != EMPTY_NODE_ID ? id : m_id;
   SeqNo newSeq = m_logic.getSeqNo(pubId) + 1;
@@ -73,15 +91,648 @@ SocketBase::publishData(const Block& content, const ndn::time::milliseconds& fre
 
   m_keyChain.sign(*data, m_securityOptions.dataSigningInfo);
 
-  m_dataStore->insert(*data);
+  {
+    // An interest for the data is either held before it is stored, or finds it in the store
+    std::lock_guard<std::mutex> lock(m_pendingInterestsMutex);
+    m_dataStore->insert(*data);
+    satisfyPendingInterests(*data);
+  }
+  m_metrics.storeInserts.increment();
+  m_metrics.dataPublished.increment();
+  if (m_inlineThreshold > 0 && content.value_size() <= m_inlineThreshold)
+    m_logic.addInlineData(*data);
   m_logic.updateSeqNo(newSeq, pubId);
 }
 
+void
+SocketBase::satisfyPendingInterests(const Data& data)
+{
+  auto now = time::steady_clock::now();
+  for (auto it = m_pendingInterests.begin(); it != m_pendingInterests.end();)
+  {
+    if (it->expiry <= now)
+    {
+      it = m_pendingInterests.erase(it);
+    }
+    else if (it->interest.matchesData(data))
+    {
+      m_face.put(data);
+      m_metrics.dataInterestsSatisfied.increment();
+      it = m_pendingInterests.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void
+SocketBase::onInlineData(const Data& data)
+{
+  if (static_cast<bool>(m_securityOptions.validator))
+    m_securityOptions.validator->validate(data,
+                                          bind(&SocketBase::onInlineDataValidated, this, _1),
+                                          [this] (const Data&, const ValidationError&) {
+                                            m_metrics.fetchValidationFailed.increment();
+                                          });
+  else
+    onInlineDataValidated(data);
+}
+
+void
+SocketBase::onInlineDataValidated(const Data& data)
+{
+  if (shouldCache(data))
+    cacheData(data);
+
+  if (m_onInlineData)
+  {
+    m_inlineDelivered.insert(data.getName());
+    m_onInlineData(data);
+  }
+}
+
+void
+SocketBase::setDeliveryCallback(const DataValidatedCallback& onDelivered,
+                                time::milliseconds retryInterval,
+                                size_t maxAttempts)
+{
+  m_onDelivered = onDelivered;
+  m_gapRetryInterval = retryInterval;
+  m_maxFetchAttempts = maxAttempts;
+}
+
+void
+SocketBase::setOrderedDelivery(size_t bufferSize)
+{
+  m_orderedBufferSize = bufferSize;
+  m_orderedNodes.clear();
+}
+
+bool
+SocketBase::fetchTracked(const NodeID& nid, const SeqNo& seq)
+{
+  if (m_deliveryTracker.isDelivered(nid, seq))
+    return false;
+
+  if (m_orderedBufferSize > 0)
+  {
+    // Fetched when the window reaches it
+    if (seq - m_deliveryTracker.getWatermark(nid) > m_orderedBufferSize)
+      return false;
+
+    auto it = m_orderedNodes.find(nid);
+    if (it != m_orderedNodes.end() && it->second.buffer.has(seq))
+      return false;
+  }
+
+  if (!m_trackedInFlight[nid].insert(seq).second)
+    return false;
+
+  fetchData(nid, seq,
+            [this, nid, seq] (const Data& data) {
+              onTrackedData(nid, seq, data);
+            },
+            [this, nid, seq] (const Data&, const ValidationError&) {
+              onTrackedFetchFailed(nid, seq, true);
+            },
+            [this, nid, seq] (const Interest&) {
+              onTrackedFetchFailed(nid, seq, false);
+            });
+  return true;
+}
+
+void
+SocketBase::onTrackedData(const NodeID& nid, const SeqNo& seq, const Data& data)
+{
+  m_trackedInFlight[nid].erase(seq);
+
+  auto failures = m_trackedFailures.find(nid);
+  if (failures != m_trackedFailures.end())
+  {
+    failures->second.erase(seq);
+    if (failures->second.empty())
+      m_trackedFailures.erase(failures);
+  }
+
+  if (m_orderedBufferSize == 0)
+  {
+    if (m_deliveryTracker.markDelivered(nid, seq) && m_onDelivered)
+      m_onDelivered(data);
+    return;
+  }
+
+  if (m_deliveryTracker.isDelivered(nid, seq))
+    return;
+
+  OrderedNode& node = getOrderedNode(nid);
+  // Catch up with the seqNos skipped since the last release
+  node.buffer.skipTo(m_deliveryTracker.getWatermark(nid) + 1);
+  node.buffer.insert(seq, data);
+  releaseOrdered(nid);
+}
+
+SocketBase::OrderedNode&
+SocketBase::getOrderedNode(const NodeID& nid)
+{
+  auto it = m_orderedNodes.find(nid);
+  if (it == m_orderedNodes.end())
+    it = m_orderedNodes.emplace(std::piecewise_construct, std::forward_as_tuple(nid),
+                                std::forward_as_tuple(m_orderedBufferSize,
+                                                      m_deliveryTracker.getWatermark(nid) + 1)).first;
+  return it->second;
+}
+
+void
+SocketBase::skipDelivery(const NodeID& nid, const SeqNo& low, const SeqNo& high)
+{
+  m_deliveryTracker.markSkipped(nid, low, high);
+
+  auto failures = m_trackedFailures.find(nid);
+  if (failures != m_trackedFailures.end())
+  {
+    auto& counts = failures->second;
+    counts.erase(counts.lower_bound(low), counts.upper_bound(high));
+    if (counts.empty())
+      m_trackedFailures.erase(failures);
+  }
+
+  releaseOrdered(nid);
+}
+
+void
+SocketBase::releaseOrdered(const NodeID& nid)
+{
+  if (m_orderedBufferSize == 0)
+    return;
+
+  // A node may have seqNos skipped before any of its packets arrived
+  OrderedNode& node = getOrderedNode(nid);
+  while (true)
+  {
+    node.buffer.release([this, &nid] (const SeqNo& seq, const Data& data) {
+      if (m_deliveryTracker.markDelivered(nid, seq) && m_onDelivered)
+        m_onDelivered(data);
+    });
+
+    // Pass over the seqNos skipped
+    SeqNo watermark = m_deliveryTracker.getWatermark(nid);
+    if (watermark < node.buffer.getNext())
+      break;
+    node.buffer.skipTo(watermark + 1);
+  }
+
+  SeqNo next = node.buffer.getNext();
+  if (node.buffer.size() == 0 || m_headOfLineTimeout <= time::milliseconds::zero())
+  {
+    node.headOfLineEvent.cancel();
+    node.timedHead = 0;
+  }
+  else if (node.timedHead != next)
+  {
+    node.timedHead = next;
+    node.headOfLineEvent = m_scheduler.schedule(m_headOfLineTimeout, [this, nid] {
+      onHeadOfLineTimeout(nid);
+    });
+  }
+
+  // Fetch the seqNos that entered the window
+  SeqNo known = m_deliveryTracker.getKnown(nid);
+  for (SeqNo seq = next; seq < next + m_orderedBufferSize && seq <= known; ++seq)
+    fetchTracked(nid, seq);
+}
+
+void
+SocketBase::onHeadOfLineTimeout(const NodeID& nid)
+{
+  auto it = m_orderedNodes.find(nid);
+  if (it == m_orderedNodes.end())
+    return;
+
+  OrderedNode& node = it->second;
+  node.timedHead = 0;
+  node.buffer.skipTo(m_deliveryTracker.getWatermark(nid) + 1);
+  SeqNo first = node.buffer.getFirst();
+  if (first == 0)
+    return;
+
+  SeqNo next = node.buffer.getNext();
+  m_deliveryTracker.markSkipped(nid, next, first - 1);
+  m_metrics.deliverySkipped.increment(first - next);
+  releaseOrdered(nid);
+}
+
+void
+SocketBase::onTrackedFetchFailed(const NodeID& nid, const SeqNo& seq, bool isValidationFailure)
+{
+  m_trackedInFlight[nid].erase(seq);
+  if (m_deliveryTracker.isDelivered(nid, seq))
+    return;
+
+  // Data that failed validation would fail again
+  size_t nFailures = ++m_trackedFailures[nid][seq];
+  if (isValidationFailure || m_skipOnLoss ||
+      (m_maxFetchAttempts > 0 && nFailures >= m_maxFetchAttempts))
+    return skipFailed(nid, seq);
+
+  if (m_isGapRetryScheduled)
+    return;
+
+  m_isGapRetryScheduled = true;
+  m_gapRetryEvent = m_scheduler.schedule(m_gapRetryInterval, [this] { refetchGaps(); });
+}
+
+void
+SocketBase::skipFailed(const NodeID& nid, const SeqNo& seq)
+{
+  m_metrics.deliverySkipped.increment();
+  skipDelivery(nid, seq, seq);
+}
+
+void
+SocketBase::refetchGaps()
+{
+  m_isGapRetryScheduled = false;
+  if (!m_onDelivered)
+    return;
+
+  for (const auto& gap : m_deliveryTracker.getGaps())
+  {
+    SeqNo high = gap.high;
+    if (m_orderedBufferSize > 0)
+      high = std::min(high, m_deliveryTracker.getWatermark(gap.session) + m_orderedBufferSize);
+
+    for (SeqNo seq = gap.low; seq <= high; ++seq)
+    {
+      if (fetchTracked(gap.session, seq))
+        m_metrics.gapsRefetched.increment();
+    }
+  }
+}
+
+void
+SocketBase::subscribe(const NodeID& nid, const DataValidatedCallback& onValidated,
+                      time::milliseconds lifetime)
+{
+  // Subscriptions are only touched on the face's thread
+  m_face.getIoService().post([=] {
+    Subscription& sub = m_subscriptions[nid];
+    sub.onValidated = onValidated;
+    sub.lifetime = lifetime;
+    sub.next = m_logic.getSeqNo(nid) + 1;
+    expressSubscriptionInterest(nid);
+  });
+}
+
+void
+SocketBase::unsubscribe(const NodeID& nid)
+{
+  m_face.getIoService().post([=] {
+    m_subscriptions.erase(nid);
+  });
+}
+
+void
+SocketBase::expressSubscriptionInterest(const NodeID& nid)
+{
+  auto it = m_subscriptions.find(nid);
+  if (it == m_subscriptions.end())
+    return;
+
+  Subscription& sub = it->second;
+  SeqNo seq = sub.next;
+
+  Interest interest(getDataName(nid, seq));
+  interest.setMustBeFresh(true);
+  interest.setCanBePrefix(false);
+  interest.setInterestLifetime(sub.lifetime);
+
+  DataValidatedCallback dataCallback = bind(&SocketBase::onSubscriptionData, this, nid, seq, _1);
+  DataValidationErrorCallback failCallback =
+    [this, nid] (const Data&, const ValidationError&) { retrySubscription(nid); };
+
+  sub.interest = m_face.expressInterest(interest,
+    bind(&SocketBase::onData, this, _1, _2, time::steady_clock::now(), dataCallback, failCallback),
+    [this, nid] (const Interest&, const lp::Nack&) { retrySubscription(nid); },
+    [this, nid] (const Interest&) { expressSubscriptionInterest(nid); });
+  m_metrics.fetchInterestsSent.increment();
+}
+
+void
+SocketBase::retrySubscription(const NodeID& nid)
+{
+  auto it = m_subscriptions.find(nid);
+  if (it == m_subscriptions.end())
+    return;
+
+  it->second.retryEvent = m_scheduler.schedule(SUBSCRIPTION_RETRY_DELAY, [this, nid] {
+    expressSubscriptionInterest(nid);
+  });
+}
+
+void
+SocketBase::onSubscriptionData(const NodeID& nid, const SeqNo& seq, const Data& data)
+{
+  auto it = m_subscriptions.find(nid);
+  if (it == m_subscriptions.end() || it->second.next != seq)
+    return;
+
+  it->second.next = seq + 1;
+  m_metrics.subscriptionData.increment();
+
+  // The callback may unsubscribe
+  DataValidatedCallback onValidated = it->second.onValidated;
+  expressSubscriptionInterest(nid);
+  onValidated(data);
+}
+
+void
+SocketBase::publishSnapshot(const Block& content, const ndn::time::milliseconds& freshness,
+                            const NodeID& id)
+{
+  NodeID pubId = id != EMPTY_NODE_ID ? id : m_id;
+  SeqNo seq = m_logic.getSeqNo(pubId);
+
+  Name snapshotName = getSnapshotPrefix(pubId).appendNumber(seq);
+  shared_ptr<Data> data = make_shared<Data>(snapshotName);
+  data->setContent(content);
+  data->setFreshnessPeriod(freshness);
+
+  m_keyChain.sign(*data, m_securityOptions.dataSigningInfo);
+
+  {
+    std::lock_guard<std::mutex> lock(m_snapshotsMutex);
+    m_snapshots[pubId] = data;
+  }
+  m_metrics.snapshotsPublished.increment();
+}
+
+void
+SocketBase::fetchSnapshot(const NodeID& nid,
+                          const SnapshotCallback& onSnapshot,
+                          const TimeoutCallback& onTimeout,
+                          int nRetries)
+{
+  Name prefix = getSnapshotPrefix(nid);
+  Interest interest(prefix);
+  interest.setMustBeFresh(true);
+  interest.setCanBePrefix(true);
+
+  DataValidatedCallback onValidated =
+    [this, prefix, onSnapshot] (const Data& data) {
+      const Name& name = data.getName();
+      if (name.size() != prefix.size() + 1 || !name.get(-1).isNumber())
+        return;
+
+      m_metrics.snapshotsFetched.increment();
+      onSnapshot(data, name.get(-1).toNumber());
+    };
+  DataValidationErrorCallback onValidationFailed =
+    bind(&SocketBase::onDataValidationFailed, this, _1, _2);
+
+  auto start = time::steady_clock::now();
+  m_face.expressInterest(interest,
+                         bind(&SocketBase::onData, this, _1, _2, start, onValidated, onValidationFailed),
+                         bind(&SocketBase::onDataTimeout, this, _1, nRetries, start,
+                              onValidated, onValidationFailed, onTimeout), // Nack
+                         bind(&SocketBase::onDataTimeout, this, _1, nRetries, start,
+                              onValidated, onValidationFailed, onTimeout));
+  m_metrics.fetchInterestsSent.increment();
+}
+
+Name
+SocketBase::getSnapshotPrefix(const NodeID& nid)
+{
+  return getDataPrefix(nid).append(SNAPSHOT_COMPONENT);
+}
+
+Name
+SocketBase::getDataPrefix(const NodeID& nid)
+{
+  std::lock_guard<std::mutex> lock(m_dataPrefixMutex);
+
+  auto it = m_dataPrefixes.find(nid);
+  if (it != m_dataPrefixes.end())
+  {
+    m_dataPrefixLru.splice(m_dataPrefixLru.begin(), m_dataPrefixLru, it->second.lru);
+    return it->second.prefix;
+  }
+
+  Name prefix = makeDataPrefix(nid);
+  // Encode once, so that copies share the wire of the components
+  prefix.wireEncode();
+
+  // Nodes that left or were pruned are the least recently used
+  if (m_dataPrefixes.size() >= MAX_DATA_PREFIXES)
+  {
+    m_dataPrefixes.erase(m_dataPrefixLru.back());
+    m_dataPrefixLru.pop_back();
+  }
+  m_dataPrefixLru.push_front(nid);
+  m_dataPrefixes.emplace(nid, DataPrefix{m_dataPrefixLru.begin(), prefix});
+  return prefix;
+}
+
+void
+SocketBase::onUpdate(const std::vector<MissingDataInfo>& v)
+{
+  if (m_latestCount == 0 && m_timeHorizon <= time::milliseconds::zero() &&
+      m_subscriptions.empty() && m_inlineDelivered.empty() && !m_onDelivered)
+    return m_onUpdate(v);
+
+  std::vector<MissingDataInfo> trimmed;
+  trimmed.reserve(v.size());
+  for (const auto& reported : v)
+  {
+    MissingDataInfo info = reported;
+    trimUpdate(info);
+    if (m_onDelivered)
+      trackUpdate(reported, info);
+    if (info.low <= info.high)
+      trimmed.push_back(info);
+  }
+
+  m_inlineDelivered.clear();
+  if (!trimmed.empty())
+    m_onUpdate(trimmed);
+}
+
+void
+SocketBase::trimUpdate(MissingDataInfo& info)
+{
+  // Received inline just before this update
+  if (!m_inlineDelivered.empty())
+  {
+    while (info.low <= info.high && m_inlineDelivered.erase(getDataName(info.session, info.high)))
+      --info.high;
+    while (info.low <= info.high && m_inlineDelivered.erase(getDataName(info.session, info.low)))
+      ++info.low;
+  }
+
+  // Already delivered through a subscription
+  auto sub = m_subscriptions.find(info.session);
+  if (sub != m_subscriptions.end())
+    info.low = std::max(info.low, sub->second.next);
+
+  if (info.low > info.high)
+    return;
+
+  SeqNo limit = getUpdateLimit(info);
+  if (limit > 0 && info.high - info.low + 1 > limit)
+  {
+    m_metrics.updatesTrimmed.increment(info.high - info.low + 1 - limit);
+    info.low = info.high - limit + 1;
+  }
+}
+
+void
+SocketBase::trackUpdate(const MissingDataInfo& reported, const MissingDataInfo& kept)
+{
+  const NodeID& nid = reported.session;
+
+  // Reported before delivery was tracked
+  if (m_deliveryTracker.getKnown(nid) == 0)
+    m_deliveryTracker.markSkipped(nid, 1, reported.low - 1);
+  m_deliveryTracker.setKnown(nid, reported.high);
+
+  if (kept.low > kept.high)
+    return m_deliveryTracker.markSkipped(nid, reported.low, reported.high);
+
+  m_deliveryTracker.markSkipped(nid, reported.low, kept.low - 1);
+  m_deliveryTracker.markSkipped(nid, kept.high + 1, reported.high);
+  for (SeqNo seq = kept.low; seq <= kept.high; ++seq)
+    fetchTracked(nid, seq);
+}
+
+SeqNo
+SocketBase::getUpdateLimit(const MissingDataInfo& info)
+{
+  SeqNo limit = m_latestCount;
+
+  if (m_timeHorizon > time::milliseconds::zero())
+  {
+    auto now = time::steady_clock::now();
+    SeqNo inHorizon = 1;
+
+    auto it = m_lastUpdate.find(info.session);
+    if (it != m_lastUpdate.end() && info.high > it->second.first)
+    {
+      // Assume the seqNos since the last update were published evenly
+      double elapsed = time::duration_cast<time::microseconds>(now - it->second.second).count();
+      double horizon = time::duration_cast<time::microseconds>(m_timeHorizon).count();
+      SeqNo advanced = info.high - it->second.first;
+      inHorizon = elapsed <= horizon ? advanced :
+                  std::max<SeqNo>(1, static_cast<SeqNo>(std::ceil(advanced * horizon / elapsed)));
+    }
+    m_lastUpdate[info.session] = {info.high, now};
+
+    limit = limit == 0 ? inHorizon : std::min(limit, inHorizon);
+  }
+
+  return limit;
+}
+
 void
 SocketBase::onDataInterest(const Interest &interest) {
+  m_metrics.dataInterestsReceived.increment();
+
+  shared_ptr<const Data> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(m_snapshotsMutex);
+    for (const auto& entry : m_snapshots)
+    {
+      if (interest.matchesData(*entry.second))
+      {
+        snapshot = entry.second;
+        break;
+      }
+    }
+  }
+  if (snapshot != nullptr)
+  {
+    m_face.put(*snapshot);
+    m_metrics.dataInterestsSatisfied.increment();
+    return;
+  }
+
   auto data = m_dataStore->find(interest);
+  if (m_cachePolicy)
+  {
+    if (data != nullptr)
+      m_cachePolicy->onHit(data->getName());
+    else
+      m_cachePolicy->onRequest(interest.getName());
+  }
+
   if (data != nullptr)
+  {
+    auto delay = getReplyDelay(interest, *data);
+    if (delay > time::milliseconds::zero())
+      return scheduleReply(interest, data, delay);
+
+    m_face.put(*data);
+    m_metrics.dataInterestsSatisfied.increment();
+    return;
+  }
+
+  // Hold interests for data of this node that is not yet published
+  const Name& name = interest.getName();
+  if (!name.empty() && name.get(-1).isNumber())
+  {
+    SeqNo seq = name.get(-1).toNumber();
+    if (seq > m_logic.getSeqNo(m_id) && getDataName(m_id, seq) == name)
+    {
+      std::lock_guard<std::mutex> lock(m_pendingInterestsMutex);
+
+      // Published by another thread since the lookup above
+      auto published = m_dataStore->find(interest);
+      if (published != nullptr)
+      {
+        m_face.put(*published);
+        m_metrics.dataInterestsSatisfied.increment();
+        return;
+      }
+
+      m_pendingInterests.remove_if([&name] (const PendingInterest& pending) {
+        return pending.interest.getName() == name;
+      });
+      if (m_pendingInterests.size() >= MAX_PENDING_INTERESTS)
+        m_pendingInterests.pop_front();
+      m_pendingInterests.push_back({interest,
+                                    time::steady_clock::now() + interest.getInterestLifetime()});
+    }
+  }
+}
+
+void
+SocketBase::scheduleReply(const Interest& interest, shared_ptr<const Data> data,
+                          time::milliseconds delay)
+{
+  Name name = data->getName();
+  if (m_pendingReplies.count(name) > 0)
+    return;
+
+  PendingReply& reply = m_pendingReplies[name];
+  reply.event = m_scheduler.schedule(delay, [this, name, data] {
     m_face.put(*data);
+    m_metrics.dataInterestsSatisfied.increment();
+    m_pendingReplies.erase(name);
+  });
+
+  // Listen for the reply of another node. The listener has the selectors of
+  // the request, so the forwarder aggregates it with the request and a stale
+  // cached copy cannot satisfy it, and a hop limit of zero keeps it local.
+  Interest listener(interest);
+  listener.refreshNonce();
+  listener.setHopLimit(0);
+  listener.setInterestLifetime(delay + interest.getInterestLifetime());
+  reply.listener = m_face.expressInterest(listener,
+    [this, name] (const Interest&, const Data&) {
+      if (m_pendingReplies.erase(name) > 0)
+        m_metrics.repliesSuppressed.increment();
+    },
+    nullptr, nullptr);
 }
 
 void
@@ -89,22 +740,12 @@ SocketBase::fetchData(const NodeID& nid, const SeqNo& seqNo,
                   const DataValidatedCallback& onValidated,
                   int nRetries)
 {
-  Name interestName = getDataName(nid, seqNo);
-  Interest interest(interestName);
-  interest.setMustBeFresh(true);
-  interest.setCanBePrefix(false);
-
   DataValidationErrorCallback onValidationFailed =
     bind(&SocketBase::onDataValidationFailed, this, _1, _2);
   TimeoutCallback onTimeout =
     [] (const Interest& interest) {};
 
-  m_face.expressInterest(interest,
-                         bind(&SocketBase::onData, this, _1, _2, onValidated, onValidationFailed),
-                         bind(&SocketBase::onDataTimeout, this, _1, nRetries,
-                              onValidated, onValidationFailed, onTimeout), // Nack
-                         bind(&SocketBase::onDataTimeout, this, _1, nRetries,
-                              onValidated, onValidationFailed, onTimeout));
+  fetchData(nid, seqNo, onValidated, onValidationFailed, onTimeout, nRetries);
 }
 
 void
@@ -115,61 +756,181 @@ SocketBase::fetchData(const NodeID& nid, const SeqNo& seqNo,
                       int nRetries)
 {
   Name interestName = getDataName(nid, seqNo);
-  Interest interest(interestName);
-  interest.setMustBeFresh(true);
-  interest.setCanBePrefix(false);
 
-  m_face.expressInterest(interest,
-                         bind(&SocketBase::onData, this, _1, _2, onValidated, onValidationFailed),
-                         bind(&SocketBase::onDataTimeout, this, _1, nRetries,
-                              onValidated, onValidationFailed, onTimeout), // Nack
-                         bind(&SocketBase::onDataTimeout, this, _1, nRetries,
-                              onValidated, onValidationFailed, onTimeout));
+  // Everything in the store was validated or produced locally
+  Interest lookup(interestName);
+  lookup.setCanBePrefix(false);
+  auto stored = m_dataStore->find(lookup);
+  if (stored != nullptr)
+  {
+    m_metrics.fetchStoreHits.increment();
+    m_face.getIoService().post([stored, onValidated] { onValidated(*stored); });
+    return;
+  }
+
+  m_fetchScheduler.enqueue(nid, [=] (const FetchScheduler::DoneCallback& done) {
+    Interest interest(interestName);
+    interest.setMustBeFresh(true);
+    interest.setCanBePrefix(false);
+
+    // Release the slot of the fetch however it ends
+    DataValidatedCallback dataCallback = [done, onValidated] (const Data& data) {
+      done();
+      onValidated(data);
+    };
+    DataValidationErrorCallback failCallback =
+      [done, onValidationFailed] (const Data& data, const ValidationError& error) {
+        done();
+        onValidationFailed(data, error);
+      };
+    TimeoutCallback timeoutCallback = [done, onTimeout] (const Interest& interest) {
+      done();
+      onTimeout(interest);
+    };
+
+    NDN_SVS_TRACE(trace::Event::FETCH_TX, this, seqNo, nRetries);
+    auto start = time::steady_clock::now();
+    m_face.expressInterest(interest,
+                           bind(&SocketBase::onData, this, _1, _2, start, dataCallback, failCallback),
+                           bind(&SocketBase::onDataTimeout, this, _1, nRetries, start,
+                                dataCallback, failCallback, timeoutCallback), // Nack
+                           bind(&SocketBase::onDataTimeout, this, _1, nRetries, start,
+                                dataCallback, failCallback, timeoutCallback));
+    m_metrics.fetchInterestsSent.increment();
+  });
+}
+
+std::future<Data>
+SocketBase::fetch(const NodeID& nid, const SeqNo& seq, int nRetries)
+{
+  auto promise = make_shared<std::promise<Data>>();
+  auto future = promise->get_future();
+
+  m_face.getIoService().post([=] {
+    fetchData(nid, seq,
+              [promise] (const Data& data) {
+                promise->set_value(data);
+              },
+              [promise] (const Data& data, const ValidationError& error) {
+                promise->set_exception(std::make_exception_ptr(
+                  Error("Validation of " + data.getName().toUri() + " failed: " + error.getInfo())));
+              },
+              [promise] (const Interest& interest) {
+                promise->set_exception(std::make_exception_ptr(
+                  Error("Fetching " + interest.getName().toUri() + " timed out")));
+              },
+              nRetries);
+  });
+
+  return future;
+}
+
+std::vector<std::future<Data>>
+SocketBase::fetchRange(const NodeID& nid, const SeqNo& low, const SeqNo& high, int nRetries)
+{
+  std::vector<std::future<Data>> futures;
+  if (low > high)
+    return futures;
+
+  futures.reserve(high - low + 1);
+  for (SeqNo seq = low; seq <= high; ++seq)
+    futures.push_back(fetch(nid, seq, nRetries));
+  return futures;
 }
 
 void
 SocketBase::onData(const Interest& interest, const Data& data,
+                   const time::steady_clock::TimePoint& start,
                    const DataValidatedCallback& onValidated,
                    const DataValidationErrorCallback& onFailed)
 {
+  NDN_SVS_TRACE(trace::Event::FETCH_RX, this,
+                data.getName().get(-1).isNumber() ? data.getName().get(-1).toNumber() : 0);
+
   if (static_cast<bool>(m_securityOptions.validator))
     m_securityOptions.validator->validate(data,
-                                          bind(&SocketBase::onDataValidated, this, _1, onValidated),
-                                          onFailed);
+                                          bind(&SocketBase::onDataValidated, this, _1, start, onValidated),
+                                          [this, onFailed] (const Data& data, const ValidationError& error) {
+                                            m_metrics.fetchValidationFailed.increment();
+                                            onFailed(data, error);
+                                          });
   else
-    onDataValidated(data, onValidated);
+    onDataValidated(data, start, onValidated);
 }
 
 void
 SocketBase::onDataTimeout(const Interest& interest, int nRetries,
+                          const time::steady_clock::TimePoint& start,
                           const DataValidatedCallback& dataCallback,
                           const DataValidationErrorCallback& failCallback,
                           const TimeoutCallback& timeoutCallback)
 {
   if (nRetries <= 0)
+  {
+    m_metrics.fetchTimeouts.increment();
+    NDN_SVS_TRACE(trace::Event::FETCH_TIMEOUT, this);
     return timeoutCallback(interest);
+  }
+  NDN_SVS_TRACE(trace::Event::FETCH_RETRY, this, nRetries - 1);
 
   Interest newNonceInterest(interest);
   newNonceInterest.refreshNonce();
 
   m_face.expressInterest(newNonceInterest,
-                         bind(&SocketBase::onData, this, _1, _2, dataCallback, failCallback),
-                         bind(&SocketBase::onDataTimeout, this, _1, nRetries - 1,
+                         bind(&SocketBase::onData, this, _1, _2, start, dataCallback, failCallback),
+                         bind(&SocketBase::onDataTimeout, this, _1, nRetries - 1, start,
                               dataCallback, failCallback, timeoutCallback), // Nack
-                         bind(&SocketBase::onDataTimeout, this, _1, nRetries - 1,
+                         bind(&SocketBase::onDataTimeout, this, _1, nRetries - 1, start,
                               dataCallback, failCallback, timeoutCallback));
+  m_metrics.fetchInterestsSent.increment();
+  m_metrics.fetchRetries.increment();
 }
 
 void
 SocketBase::onDataValidated(const Data& data,
+                            const time::steady_clock::TimePoint& start,
                             const DataValidatedCallback& dataCallback)
 {
+  m_metrics.fetchValidated.increment();
+  m_metrics.fetchLatency.record(time::duration_cast<time::microseconds>(
+    time::steady_clock::now() - start).count());
+
   if (shouldCache(data))
-    m_dataStore->insert(data);
+    cacheData(data);
 
   dataCallback(data);
 }
 
+void
+SocketBase::cacheData(const Data& data)
+{
+  // E.g. received inline and fetched again, or by a subscription and a fetch
+  Interest lookup(data.getName());
+  lookup.setCanBePrefix(false);
+  if (m_dataStore->find(lookup) != nullptr)
+    return;
+
+  std::vector<Name> evicted;
+  if (!m_cachePolicy || m_cachePolicy->admit(data, evicted))
+  {
+    m_dataStore->insert(data);
+    m_metrics.storeInserts.increment();
+  }
+
+  for (const auto& name : evicted)
+    m_dataStore->erase(name);
+  m_metrics.cacheEvictions.increment(evicted.size());
+}
+
+MetricsSnapshot
+SocketBase::getMetricsSnapshot() const
+{
+  MetricsSnapshot snapshot;
+  m_metrics.snapshot(snapshot);
+  m_logic.getMetrics().snapshot(snapshot);
+  return snapshot;
+}
+
 void
 SocketBase::onDataValidationFailed(const Data& data,
                                    const ValidationError& error)
@@ -17,11 +17,21 @@
 #ifndef NDN_SVS_SOCKET_BASE_HPP
 #define NDN_SVS_SOCKET_BASE_HPP
 
+#include "cache-policy.hpp"
 #include "common.hpp"
+#include "delivery-tracker.hpp"
+#include "fetch-scheduler.hpp"
 #include "logic.hpp"
+#include "reorder-buffer.hpp"
 #include "store.hpp"
 #include "security-options.hpp"
 
+#include <future>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+
 namespace ndn {
 namespace svs {
 
@@ -50,6 +60,13 @@ namespace svs {
  */
 class SocketBase : noncopyable
 {
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
 public:
   SocketBase(const Name& syncPrefix,
              const Name& dataPrefix,
@@ -65,6 +82,8 @@ public:
 
   using DataValidationErrorCallback = function<void(const Data&, const ValidationError& error)> ;
 
+  using SnapshotCallback = function<void(const Data& data, const SeqNo& seq)>;
+
   /**
    * @brief Publish a data packet in the session and trigger synchronization updates
    *
@@ -79,7 +98,7 @@ public:
    */
   void
   publishData(const uint8_t* buf, size_t len, const ndn::time::milliseconds& freshness,
-              const NodeID id = EMPTY_NODE_ID);
+              const NodeID& id = EMPTY_NODE_ID);
 
   /**
    * @brief Publish a data packet in the session and trigger synchronization updates
@@ -94,7 +113,7 @@ public:
    */
   void
   publishData(const Block& content, const ndn::time::milliseconds& freshness,
-              const NodeID id = EMPTY_NODE_ID);
+              const NodeID& id = EMPTY_NODE_ID);
 
   /**
    * @brief Retrive a data packet with a particular seqNo from a session
@@ -112,6 +131,11 @@ public:
   /**
    * @brief Retrive a data packet with a particular seqNo from a session
    *
+   * A packet found in the data store is delivered asynchronously without
+   * sending an interest or validating it again. Otherwise the fetch is
+   * queued per node in the fetch scheduler, which decides when the
+   * interest is sent.
+   *
    * @param sessionName The name of the target session.
    * @param seq The seqNo of the data packet.
    * @param onValidated The callback when the retrieved packet has been validated.
@@ -126,6 +150,246 @@ public:
             const TimeoutCallback& onTimeout,
             int nRetries = 0);
 
+  /**
+   * @brief Retrieve a data packet as a future
+   *
+   * The fetch is started on the face's io_service, so this may be called
+   * from any thread. The future holds the validated packet, or a
+   * SocketBase::Error if the fetch times out or validation fails.
+   * Do not wait on the future from the thread running the io_service.
+   *
+   * @param nid The node to fetch from.
+   * @param seq The seqNo of the data packet.
+   * @param nRetries The number of retries.
+   */
+  std::future<Data>
+  fetch(const NodeID& nid, const SeqNo& seq, int nRetries = 0);
+
+  /**
+   * @brief Retrieve a range of data packets as futures
+   *
+   * All fetches are queued at once, and go through the fetch scheduler
+   * like any other fetch.
+   *
+   * @return One future per seqNo from low to high
+   */
+  std::vector<std::future<Data>>
+  fetchRange(const NodeID& nid, const SeqNo& low, const SeqNo& high, int nRetries = 0);
+
+  /**
+   * @brief Carry small data packets in sync interests
+   *
+   * Packets published with a content of at most @p threshold bytes are
+   * sent in the next sync interest, within a budget per interest. Peers
+   * pass them to the inline data callback, so that they need not be
+   * fetched. 0 disables inlining (default).
+   */
+  void
+  setInlineThreshold(size_t threshold)
+  {
+    m_inlineThreshold = threshold;
+  }
+
+  /**
+   * @brief Set the callback for validated data packets carried in sync interests
+   *
+   * Packets received inline are inserted in the data store like fetched
+   * data, i.e. if shouldCache() accepts them and subject to the cache
+   * policy if one is set. If this callback is set, they are passed to it, and their seqNos are removed from the update that follows.
+   * Otherwise the update reports them as usual.
+   */
+  void
+  setInlineDataCallback(const DataValidatedCallback& onInlineData)
+  {
+    m_onInlineData = onInlineData;
+  }
+
+  /**
+   * @brief Fetch and deliver all data of other nodes, each packet once
+   *
+   * Once set, the socket fetches every seqNo reported in an update itself,
+   * and passes each validated packet to the callback once. The seqNos
+   * delivered are recorded per node in the delivery tracker, and a seqNo
+   * whose fetch timed out is fetched again every @p retryInterval, up to
+   * @p maxAttempts fetches in all, after which it is skipped. A seqNo whose
+   * data failed validation is skipped right away. A seqNo is not fetched
+   * again while its fetch is in flight. The update callback is still called.
+   *
+   * SeqNos removed from an update, e.g. by setLatestCount() or because
+   * they were received inline, are marked as skipped, as are the seqNos
+   * reported before the callback was set.
+   *
+   * @param onDelivered The callback for each validated data packet.
+   * @param retryInterval The interval between fetches of the gaps.
+   * @param maxAttempts The number of fetches of a seqNo before it is skipped,
+   *        0 for unlimited.
+   */
+  void
+  setDeliveryCallback(const DataValidatedCallback& onDelivered,
+                      time::milliseconds retryInterval = DEFAULT_GAP_RETRY_INTERVAL,
+                      size_t maxAttempts = DEFAULT_MAX_FETCH_ATTEMPTS);
+
+  /**
+   * @brief Deliver the data of each node in seqNo order
+   *
+   * Applies to the packets passed to the delivery callback. Packets of
+   * each node are held in a reorder buffer of @p bufferSize slots and
+   * delivered in runs of consecutive seqNos. Only the seqNos within the
+   * window of the buffer are fetched, so the memory held per node is
+   * bounded. SeqNos that are skipped are passed over.
+   * 0 disables ordering (default). Set before any data is fetched.
+   */
+  void
+  setOrderedDelivery(size_t bufferSize);
+
+  /**
+   * @brief Give up on missing seqNos that hold back ordered delivery
+   *
+   * Once packets are buffered behind a missing seqNo for this long, the
+   * missing seqNos before the first buffered packet are skipped.
+   * Zero waits until they are delivered (default).
+   */
+  void
+  setHeadOfLineTimeout(time::milliseconds timeout)
+  {
+    m_headOfLineTimeout = timeout;
+  }
+
+  /**
+   * @brief Skip a seqNo as soon as its fetch fails, instead of fetching it again
+   *
+   * Default false.
+   */
+  void
+  setSkipOnLoss(bool skipOnLoss)
+  {
+    m_skipOnLoss = skipOnLoss;
+  }
+
+  /**
+   * @brief Give up on a range of seqNos of a node
+   *
+   * The seqNos are no longer fetched, and ordered delivery moves past them.
+   */
+  void
+  skipDelivery(const NodeID& nid, const SeqNo& low, const SeqNo& high);
+
+  /// @brief Get the record of delivered seqNos
+  const DeliveryTracker&
+  getDeliveryTracker() const
+  {
+    return m_deliveryTracker;
+  }
+
+  /**
+   * @brief Get the seqNo up to which all data of a node was delivered or skipped
+   *
+   * Only meaningful with a delivery callback set.
+   */
+  SeqNo
+  getDeliveredWatermark(const NodeID& nid) const
+  {
+    return m_deliveryTracker.getWatermark(nid);
+  }
+
+  /**
+   * @brief Keep an interest outstanding for the next data packet of a node
+   *
+   * A long-lived interest for the seqNo after the latest one known is kept
+   * pending at the producer, which answers it as soon as the data is
+   * published, and is re-armed for the following seqNo on arrival. Data is
+   * thus delivered in about one-way delay, without waiting for the sync
+   * interest. SeqNos delivered through the subscription are removed from
+   * later updates of the node.
+   *
+   * Intended for a few hot producers, since each one holds an interest
+   * at all times. Takes effect on the face's io_service, so this may be
+   * called from any thread.
+   *
+   * @param nid The node to subscribe to.
+   * @param onValidated The callback for each validated data packet.
+   * @param lifetime InterestLifetime of the long-lived interests.
+   */
+  void
+  subscribe(const NodeID& nid, const DataValidatedCallback& onValidated,
+            time::milliseconds lifetime = DEFAULT_SUBSCRIPTION_LIFETIME);
+
+  /// @brief Stop keeping an interest outstanding for a node, from any thread
+  void
+  unsubscribe(const NodeID& nid);
+
+  /**
+   * @brief Publish a snapshot of the application state of a node
+   *
+   * The snapshot stands in for all data of the node up to and including
+   * its current seqNo, so that a new member can fetch the snapshot and then
+   * only the data published after it. Only the latest snapshot of each node
+   * is kept, and is served under getSnapshotPrefix(id)/<seq>.
+   *
+   * @param content Block that will be set as the content of the snapshot.
+   * @param freshness FreshnessPeriod of the snapshot packet.
+   * @param id NodeID to publish the snapshot under
+   */
+  void
+  publishSnapshot(const Block& content, const ndn::time::milliseconds& freshness,
+                  const NodeID& id = EMPTY_NODE_ID);
+
+  /**
+   * @brief Retrieve the latest snapshot of a node
+   *
+   * A node that learns of a long history, e.g. MissingDataInfo{1, N} after
+   * joining, can fetch the snapshot first and then only the seqNos above the
+   * one it covers. If no snapshot is available, onTimeout is called and the
+   * application should fall back to fetching the whole history.
+   *
+   * @param nid The node to fetch the snapshot of.
+   * @param onSnapshot The callback with the validated snapshot and the seqNo it covers.
+   * @param onTimeout The callback when no snapshot is retrieved.
+   * @param nRetries The number of retries.
+   */
+  void
+  fetchSnapshot(const NodeID& nid,
+                const SnapshotCallback& onSnapshot,
+                const TimeoutCallback& onTimeout,
+                int nRetries = 0);
+
+  /**
+   * @brief Return the prefix under which the snapshots of a node are named
+   *
+   * This is the data name of the node without the seqNo, followed by
+   * the snapshot component.
+   */
+  Name
+  getSnapshotPrefix(const NodeID& nid);
+
+  /**
+   * @brief Only report the newest seqNos of each node to the application
+   *
+   * Each MissingDataInfo is trimmed to at most the newest @p nLatest seqNos
+   * before the update callback sees it, so that a consumer coming back from
+   * a partition fetches only fresh data. 0 disables the limit (default).
+   */
+  void
+  setLatestCount(size_t nLatest)
+  {
+    m_latestCount = nLatest;
+  }
+
+  /**
+   * @brief Only report seqNos published within a time horizon
+   *
+   * The seqNos a node published during the horizon are estimated from the
+   * number of seqNos it advanced by since its last update. For a node that
+   * was not seen before, only the newest seqNo is reported. If a latest
+   * count is also set, the smaller of the two limits applies.
+   * Zero disables the horizon (default).
+   */
+  void
+  setTimeHorizon(time::milliseconds horizon)
+  {
+    m_timeHorizon = horizon;
+  }
+
   /**
    * @brief Return data name for a given packet
    *
@@ -151,33 +415,164 @@ public:
     return m_logic;
   }
 
+  /**
+   * @brief Set the policy deciding which data of other nodes is kept
+   *
+   * Applies to the packets that the socket chooses to cache, e.g. with
+   * SocketShared::setCacheAll(true), and to packets received inline. The
+   * policy sees the data interests received, and packets it evicts are
+   * erased from the data store. The byte budget only holds for a data
+   * store that implements DataStore::erase(). Without a policy, all such
+   * packets are kept (default).
+   */
+  void
+  setCachePolicy(std::shared_ptr<CachePolicy> cachePolicy)
+  {
+    m_cachePolicy = std::move(cachePolicy);
+  }
+
+  /**
+   * @brief Get the scheduler of data fetches
+   *
+   * Can be used to cap the number of concurrent fetches and
+   * to give some nodes a larger share of the fetches.
+   */
+  FetchScheduler&
+  getFetchScheduler()
+  {
+    return m_fetchScheduler;
+  }
+
+  /// @brief Get the runtime metrics of data publishing and fetching
+  const SocketMetrics&
+  getMetrics() const
+  {
+    return m_metrics;
+  }
+
+  /**
+   * @brief Get a snapshot of the metrics of the socket and its logic
+   *
+   * Safe to call from any thread.
+   */
+  MetricsSnapshot
+  getMetricsSnapshot() const;
+
 public:
   static const NodeID EMPTY_NODE_ID;
   static const std::shared_ptr<DataStore> DEFAULT_DATASTORE;
+  static const name::Component SNAPSHOT_COMPONENT;
+  static const time::milliseconds DEFAULT_SUBSCRIPTION_LIFETIME;
+  static const time::milliseconds DEFAULT_GAP_RETRY_INTERVAL;
+  static constexpr size_t DEFAULT_MAX_FETCH_ATTEMPTS = 10;
 
 private:
+  void
+  onUpdate(const std::vector<MissingDataInfo>& v);
+
+  /// @brief Remove from an update the seqNos the application does not need
+  void
+  trimUpdate(MissingDataInfo& info);
+
+  /// @brief Record an update and fetch the seqNos kept from it for delivery
+  void
+  trackUpdate(const MissingDataInfo& reported, const MissingDataInfo& kept);
+
+  /**
+   * @brief Fetch a seqNo for delivery, unless delivered, in flight or
+   *        outside the window of ordered delivery
+   *
+   * @return whether a fetch was started
+   */
+  bool
+  fetchTracked(const NodeID& nid, const SeqNo& seq);
+
+  void
+  onTrackedData(const NodeID& nid, const SeqNo& seq, const Data& data);
+
+  void
+  onTrackedFetchFailed(const NodeID& nid, const SeqNo& seq, bool isValidationFailure);
+
+  /// @brief Give up on a seqNo whose fetch failed
+  void
+  skipFailed(const NodeID& nid, const SeqNo& seq);
+
+  struct OrderedNode;
+
+  /// @brief Get the ordered delivery state of a node, creating it at the watermark
+  OrderedNode&
+  getOrderedNode(const NodeID& nid);
+
+  /// @brief Deliver the buffered run of a node and fetch the seqNos in its window
+  void
+  releaseOrdered(const NodeID& nid);
+
+  void
+  onHeadOfLineTimeout(const NodeID& nid);
+
+  /// @brief Fetch the gaps of all nodes again
+  void
+  refetchGaps();
+
+  void
+  expressSubscriptionInterest(const NodeID& nid);
+
+  void
+  onSubscriptionData(const NodeID& nid, const SeqNo& seq, const Data& data);
+
+  /// @brief Re-arm a subscription after a delay
+  void
+  retrySubscription(const NodeID& nid);
+
+  void
+  onInlineData(const Data& data);
+
+  void
+  onInlineDataValidated(const Data& data);
+
+  /// @brief Answer a data interest after a delay, unless another node answers first
+  void
+  scheduleReply(const Interest& interest, shared_ptr<const Data> data,
+                time::milliseconds delay);
+
+  /// @brief Answer held interests of other nodes with newly published data,
+  ///        with m_pendingInterestsMutex held
+  void
+  satisfyPendingInterests(const Data& data);
+
+  /// @brief Number of seqNos to keep from an update of a node, 0 for all
+  SeqNo
+  getUpdateLimit(const MissingDataInfo& info);
+
   void
   onDataInterest(const Interest &interest);
 
   void
   onData(const Interest& interest, const Data& data,
+         const time::steady_clock::TimePoint& start,
          const DataValidatedCallback& dataCallback,
          const DataValidationErrorCallback& failCallback);
 
   void
   onDataTimeout(const Interest& interest, int nRetries,
+                const time::steady_clock::TimePoint& start,
                 const DataValidatedCallback& dataCallback,
                 const DataValidationErrorCallback& failCallback,
                 const TimeoutCallback& timeoutCallback);
 
   void
   onDataValidated(const Data& data,
+                  const time::steady_clock::TimePoint& start,
                   const DataValidatedCallback& dataCallback);
 
   void
   onDataValidationFailed(const Data& data,
                          const ValidationError& error);
 
+  /// @brief Insert data of another node in the store, through the cache policy
+  void
+  cacheData(const Data& data);
+
   /**
    * Determines whether a particular data packet is to be cached
    * Can be used to cache data packets from other nodes when
@@ -189,6 +584,41 @@ private:
       return false;
   }
 
+  /**
+   * Determines how long to wait before answering a data interest from
+   * the data store. A delayed reply is dropped if the data is received
+   * from another node in the meantime. Zero answers right away.
+   */
+  virtual time::milliseconds
+  getReplyDelay(const Interest& interest, const Data& data)
+  {
+      return time::milliseconds::zero();
+  }
+
+protected:
+  /**
+   * @brief Get the data name prefix of a node, i.e. its data name without the seqNo
+   *
+   * Prefixes are built once per node by makeDataPrefix() and cached, so
+   * that getDataName() only needs to append the seqNo. The cache keeps a
+   * fixed number of the most recently used nodes, so that it does not
+   * grow with every node ever seen. Safe to call from any thread.
+   */
+  Name
+  getDataPrefix(const NodeID& nid);
+
+  /**
+   * @brief Build the data name prefix of a node
+   *
+   * The default strips the seqNo from getDataName(); a derived class that
+   * implements getDataName() with getDataPrefix() must override this.
+   */
+  virtual Name
+  makeDataPrefix(const NodeID& nid)
+  {
+    return getDataName(nid, 0).getPrefix(-1);
+  }
+
 protected:
   const Name m_syncPrefix;
   const Name m_dataPrefix;
@@ -203,7 +633,94 @@ private:
 
   const UpdateCallback m_onUpdate;
 
+  size_t m_latestCount = 0;
+  time::milliseconds m_timeHorizon = time::milliseconds::zero();
+  std::map<NodeID, std::pair<SeqNo, time::steady_clock::TimePoint>> m_lastUpdate;
+
+  size_t m_inlineThreshold = 0;
+  DataValidatedCallback m_onInlineData;
+  // Data received inline and not yet removed from an update
+  std::set<Name> m_inlineDelivered;
+
+  DataValidatedCallback m_onDelivered;
+  time::milliseconds m_gapRetryInterval = DEFAULT_GAP_RETRY_INTERVAL;
+  DeliveryTracker m_deliveryTracker;
+  // SeqNos fetched for delivery and not yet done
+  std::map<NodeID, std::set<SeqNo>> m_trackedInFlight;
+  size_t m_maxFetchAttempts = DEFAULT_MAX_FETCH_ATTEMPTS;
+  // Failed fetches of the seqNos not yet delivered or skipped
+  std::map<NodeID, std::map<SeqNo, size_t>> m_trackedFailures;
+  bool m_isGapRetryScheduled = false;
+
+  size_t m_orderedBufferSize = 0;
+  time::milliseconds m_headOfLineTimeout = time::milliseconds::zero();
+  bool m_skipOnLoss = false;
+
   std::shared_ptr<DataStore> m_dataStore;
+  std::shared_ptr<CachePolicy> m_cachePolicy;
+
+  struct DataPrefix
+  {
+    std::list<NodeID>::iterator lru;
+    Name prefix;
+  };
+  // Most recently used first
+  std::list<NodeID> m_dataPrefixLru;
+  std::map<NodeID, DataPrefix> m_dataPrefixes;
+  std::mutex m_dataPrefixMutex;
+  std::map<NodeID, shared_ptr<const Data>> m_snapshots;
+  // Snapshots are published on application threads and served on the face's thread
+  std::mutex m_snapshotsMutex;
+
+  ndn::Scheduler m_scheduler;
+  FetchScheduler m_fetchScheduler;
+
+  struct Subscription
+  {
+    DataValidatedCallback onValidated;
+    time::milliseconds lifetime;
+    /** SeqNo of the pending interest */
+    SeqNo next;
+    ScopedPendingInterestHandle interest;
+    scheduler::ScopedEventId retryEvent;
+  };
+  std::map<NodeID, Subscription> m_subscriptions;
+
+  // Interests for own data that is not yet published
+  struct PendingInterest
+  {
+    Interest interest;
+    time::steady_clock::TimePoint expiry;
+  };
+  std::list<PendingInterest> m_pendingInterests;
+  // Interests are held on the face's thread, and answered on the publishing thread
+  std::mutex m_pendingInterestsMutex;
+
+  // Delayed replies to data interests, by data name
+  struct PendingReply
+  {
+    scheduler::ScopedEventId event;
+    ScopedPendingInterestHandle listener;
+  };
+  std::map<Name, PendingReply> m_pendingReplies;
+
+  scheduler::ScopedEventId m_gapRetryEvent;
+
+  struct OrderedNode
+  {
+    OrderedNode(size_t capacity, SeqNo next)
+      : buffer(capacity, next)
+    {
+    }
+
+    ReorderBuffer buffer;
+    scheduler::ScopedEventId headOfLineEvent;
+    /** Next seqNo when the head-of-line timer was set, 0 if not set */
+    SeqNo timedHead = 0;
+  };
+  std::map<NodeID, OrderedNode> m_orderedNodes;
+
+  SocketMetrics m_metrics;
 
   Logic m_logic;
 };
@@ -19,6 +19,8 @@
 
 #include "socket-base.hpp"
 
+#include <ndn-cxx/util/random.hpp>
+
 namespace ndn {
 namespace svs {
 
@@ -48,25 +50,65 @@ public:
   Name
   getDataName(const NodeID& nid, const SeqNo& seqNo)
   {
-    return Name(m_dataPrefix).append(nid).appendNumber(seqNo);
+    return getDataPrefix(nid).appendNumber(seqNo);
   }
 
-  /*** @brief Set whether data of other nodes is also cached and served */
+  /**
+   * @brief Set whether data of other nodes is also cached and served
+   *
+   * Which packets are kept can be limited with setCachePolicy().
+   */
   void
   setCacheAll(bool val)
   {
     m_cacheAll = val;
   }
 
+  /**
+   * @brief Set the maximum delay before answering for data of other nodes
+   *
+   * With setCacheAll(true), every member holding a packet would answer
+   * each multicast data interest. Members other than the producer instead
+   * wait a random delay up to @p maxDelay and drop their reply if the data
+   * is received from another node first. The producer answers right away.
+   * Zero disables the delay.
+   */
+  void
+  setMaxReplyDelay(time::milliseconds maxDelay)
+  {
+    m_maxReplyDelay = maxDelay;
+  }
+
+public:
+  static const time::milliseconds DEFAULT_MAX_REPLY_DELAY;
+
 private:
+  Name
+  makeDataPrefix(const NodeID& nid)
+  {
+    return Name(m_dataPrefix).append(nid);
+  }
+
   bool
   shouldCache(const Data& data)
   {
     return m_cacheAll;
   }
 
+  time::milliseconds
+  getReplyDelay(const Interest& interest, const Data& data)
+  {
+    if (m_maxReplyDelay <= time::milliseconds::zero() ||
+        getDataPrefix(m_id).isPrefixOf(data.getName()))
+      return time::milliseconds::zero();
+
+    std::uniform_int_distribution<time::milliseconds::rep> dist(1, m_maxReplyDelay.count());
+    return time::milliseconds(dist(random::getRandomNumberEngine()));
+  }
+
 private:
   bool m_cacheAll = false;
+  time::milliseconds m_maxReplyDelay = DEFAULT_MAX_REPLY_DELAY;
 };
 
 }  // namespace svs
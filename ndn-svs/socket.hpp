@@ -48,7 +48,7 @@ public:
   Name
   getDataName(const NodeID& nid, const SeqNo& seqNo)
   {
-    return Name(nid).append(m_syncPrefix).appendNumber(seqNo);
+    return getDataPrefix(nid).appendNumber(seqNo);
   }
 
   /**
@@ -86,6 +86,13 @@ public:
   {
     return fetchData(nodePrefix.toUri(), seq, onValidated, onValidationFailed, onTimeout, nRetries);
   }
+
+private:
+  Name
+  makeDataPrefix(const NodeID& nid)
+  {
+    return Name(nid).append(m_syncPrefix);
+  }
 };
 
 }  // namespace svs
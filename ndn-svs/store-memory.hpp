@@ -38,6 +38,12 @@ public:
         return m_ims.insert(data);
     }
 
+    void
+    erase(const Name& name)
+    {
+        m_ims.erase(name, false);
+    }
+
 private:
     InMemoryStoragePersistent m_ims;
 };
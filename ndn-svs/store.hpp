@@ -30,6 +30,17 @@ public:
     virtual void
     insert(const Data& data) = 0;
 
+    /**
+     * @brief Remove a packet, e.g. one evicted by the cache policy
+     *
+     * The default does nothing, so a store that does not override it
+     * keeps evicted packets and exceeds the budget of the cache policy.
+     */
+    virtual void
+    erase(const Name& name)
+    {
+    }
+
     virtual ~DataStore() = default;
 };
 
@@ -0,0 +1,297 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "timer-wheel.hpp"
+
+namespace ndn {
+namespace svs {
+
+constexpr unsigned TimerWheel::SLOT_BITS;
+constexpr unsigned TimerWheel::N_SLOTS;
+constexpr unsigned TimerWheel::N_LEVELS;
+constexpr TimerWheel::Tick TimerWheel::MAX_DELTA;
+constexpr uint32_t TimerWheel::NIL;
+
+const time::nanoseconds TimerWheel::DEFAULT_TICK = time::milliseconds(1);
+
+TimerWheel::TimerWheel(ndn::Scheduler& scheduler, time::nanoseconds tick)
+  : m_scheduler(scheduler)
+  , m_tick(tick)
+  , m_epoch(time::steady_clock::now())
+{
+  BOOST_ASSERT(m_tick > time::nanoseconds::zero());
+}
+
+TimerBackend::TimerId
+TimerWheel::schedule(time::nanoseconds after, TimerCallback callback)
+{
+  uint32_t index;
+  if (m_freeList.empty())
+  {
+    index = static_cast<uint32_t>(m_entries.size());
+    m_entries.emplace_back();
+  }
+  else
+  {
+    index = m_freeList.back();
+    m_freeList.pop_back();
+  }
+
+  // Round up, so that a timer never fires before the requested delay
+  auto offset = time::steady_clock::now() - m_epoch + std::max(after, time::nanoseconds::zero());
+  Tick expiry = (time::duration_cast<time::nanoseconds>(offset).count() + m_tick.count() - 1) /
+                m_tick.count();
+
+  Entry& entry = m_entries[index];
+  entry.expiry = std::max(expiry, m_current + 1);
+  entry.callback = std::move(callback);
+  link(index);
+  ++m_nPending;
+
+  Tick next;
+  if (findNextTick(next))
+    arm(next);
+
+  return makeId(index, entry.generation);
+}
+
+void
+TimerWheel::cancel(TimerId id)
+{
+  if (id == INVALID_TIMER)
+    return;
+
+  uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFF) - 1;
+  uint32_t generation = static_cast<uint32_t>(id >> 32);
+  if (index >= m_entries.size() || m_entries[index].generation != generation)
+    return;
+
+  switch (m_entries[index].state)
+  {
+    case EntryState::LINKED:
+      unlink(index);
+      release(index);
+      break;
+
+    case EntryState::FIRING:
+      release(index);
+      break;
+
+    case EntryState::FREE:
+      return;
+  }
+
+  // Nothing left to wait for
+  if (m_nPending == 0)
+  {
+    m_wakeupEvent.cancel();
+    m_isArmed = false;
+  }
+}
+
+TimerWheel::Tick
+TimerWheel::getCurrentTick() const
+{
+  auto offset = time::duration_cast<time::nanoseconds>(time::steady_clock::now() - m_epoch);
+  return offset.count() / m_tick.count();
+}
+
+void
+TimerWheel::link(uint32_t index)
+{
+  Entry& entry = m_entries[index];
+
+  // Timers too far in the future are parked in the top level
+  // and placed again once that slot is reached
+  Tick target = std::min(entry.expiry, m_current + MAX_DELTA);
+  Tick delta = target - m_current;
+
+  unsigned level = 0;
+  while (level < N_LEVELS - 1 && delta >= (Tick(1) << (SLOT_BITS * (level + 1))))
+    ++level;
+  unsigned slot = (target >> (SLOT_BITS * level)) & (N_SLOTS - 1);
+
+  Level& lvl = m_levels[level];
+  entry.level = static_cast<uint8_t>(level);
+  entry.slot = static_cast<uint8_t>(slot);
+  entry.state = EntryState::LINKED;
+  entry.prev = NIL;
+  entry.next = lvl.heads[slot];
+  if (entry.next != NIL)
+    m_entries[entry.next].prev = index;
+  lvl.heads[slot] = index;
+  lvl.occupied |= uint64_t(1) << slot;
+}
+
+void
+TimerWheel::unlink(uint32_t index)
+{
+  Entry& entry = m_entries[index];
+  Level& lvl = m_levels[entry.level];
+
+  if (entry.prev == NIL)
+    lvl.heads[entry.slot] = entry.next;
+  else
+    m_entries[entry.prev].next = entry.next;
+
+  if (entry.next != NIL)
+    m_entries[entry.next].prev = entry.prev;
+
+  if (lvl.heads[entry.slot] == NIL)
+    lvl.occupied &= ~(uint64_t(1) << entry.slot);
+
+  entry.prev = entry.next = NIL;
+}
+
+uint32_t
+TimerWheel::detach(unsigned level, unsigned slot)
+{
+  Level& lvl = m_levels[level];
+  uint32_t head = lvl.heads[slot];
+  lvl.heads[slot] = NIL;
+  lvl.occupied &= ~(uint64_t(1) << slot);
+  return head;
+}
+
+void
+TimerWheel::release(uint32_t index)
+{
+  Entry& entry = m_entries[index];
+  entry.callback = nullptr;
+  entry.state = EntryState::FREE;
+  ++entry.generation;
+  m_freeList.push_back(index);
+  --m_nPending;
+}
+
+bool
+TimerWheel::findNextTick(Tick& tick) const
+{
+  bool found = false;
+
+  for (unsigned level = 0; level < N_LEVELS; ++level)
+  {
+    uint64_t occupied = m_levels[level].occupied;
+    if (occupied == 0)
+      continue;
+
+    // The slot boundaries of this level after the current tick
+    unsigned shift = SLOT_BITS * level;
+    Tick base = (m_current >> shift) + 1;
+    unsigned start = base & (N_SLOTS - 1);
+
+    // Rotate so that bit 0 is the first slot reached from now on
+    uint64_t rotated = start == 0 ? occupied : (occupied >> start) | (occupied << (N_SLOTS - start));
+    Tick candidate = (base + __builtin_ctzll(rotated)) << shift;
+
+    if (!found || candidate < tick)
+    {
+      tick = candidate;
+      found = true;
+    }
+  }
+
+  return found;
+}
+
+void
+TimerWheel::processTick(Tick tick, std::vector<TimerId>& expired)
+{
+  m_current = tick;
+
+  // Higher levels first, since their entries may cascade into
+  // slots of lower levels that are due at the same tick
+  for (unsigned level = N_LEVELS; level-- > 0;)
+  {
+    unsigned shift = SLOT_BITS * level;
+    if ((tick & ((Tick(1) << shift) - 1)) != 0)
+      continue;
+
+    uint32_t index = detach(level, (tick >> shift) & (N_SLOTS - 1));
+    while (index != NIL)
+    {
+      Entry& entry = m_entries[index];
+      uint32_t next = entry.next;
+      entry.prev = entry.next = NIL;
+
+      if (entry.expiry <= tick)
+      {
+        entry.state = EntryState::FIRING;
+        expired.push_back(makeId(index, entry.generation));
+      }
+      else
+      {
+        link(index);
+      }
+
+      index = next;
+    }
+  }
+}
+
+void
+TimerWheel::arm(Tick tick)
+{
+  if (m_isArmed && m_wakeupTick <= tick)
+    return;
+
+  auto delay = m_epoch + m_tick * static_cast<int64_t>(tick) - time::steady_clock::now();
+  if (delay < time::nanoseconds::zero())
+    delay = time::nanoseconds::zero();
+
+  m_wakeupTick = tick;
+  m_isArmed = true;
+  m_wakeupEvent = m_scheduler.schedule(time::duration_cast<time::nanoseconds>(delay),
+                                       [this] { onWakeup(); });
+}
+
+void
+TimerWheel::onWakeup()
+{
+  m_isArmed = false;
+
+  Tick now = getCurrentTick();
+  std::vector<TimerId> expired;
+
+  Tick next;
+  while (findNextTick(next) && next <= now)
+    processTick(next, expired);
+
+  // No slot is due before now, so it is safe to skip ahead
+  if (m_current < now)
+    m_current = now;
+
+  for (TimerId id : expired)
+  {
+    uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFF) - 1;
+    Entry& entry = m_entries[index];
+
+    // Cancelled by an earlier callback
+    if (entry.generation != static_cast<uint32_t>(id >> 32) || entry.state != EntryState::FIRING)
+      continue;
+
+    // The callback may schedule timers and reallocate the entries
+    TimerCallback callback = std::move(entry.callback);
+    release(index);
+    callback();
+  }
+
+  if (findNextTick(next))
+    arm(next);
+}
+
+}  // namespace svs
+}  // namespace ndn
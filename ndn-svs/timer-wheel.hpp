@@ -0,0 +1,168 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_TIMER_WHEEL_HPP
+#define NDN_SVS_TIMER_WHEEL_HPP
+
+#include "timer.hpp"
+
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace ndn {
+namespace svs {
+
+/**
+ * @brief Hierarchical timer wheel with O(1) schedule and cancel
+ *
+ * Timers are kept in N_LEVELS wheels of N_SLOTS slots each. Level 0 has
+ * a resolution of one tick, and every level above it covers N_SLOTS times
+ * the range of the level below. Timers are moved to lower levels as their
+ * expiry approaches. Only one event is kept on the underlying scheduler,
+ * armed for the next tick at which a slot needs processing, so inserting
+ * or cancelling a timer never touches the scheduler's queue unless the
+ * new timer is the earliest one.
+ */
+class TimerWheel : public TimerBackend
+{
+public:
+  /**
+   * @param scheduler Scheduler used to wake up the wheel
+   * @param tick Resolution of the wheel
+   */
+  explicit
+  TimerWheel(ndn::Scheduler& scheduler, time::nanoseconds tick = DEFAULT_TICK);
+
+  TimerId
+  schedule(time::nanoseconds after, TimerCallback callback) override;
+
+  void
+  cancel(TimerId id) override;
+
+  /// @brief Number of timers that have not fired or been cancelled
+  size_t
+  size() const
+  {
+    return m_nPending;
+  }
+
+public:
+  static const time::nanoseconds DEFAULT_TICK;
+
+private:
+  using Tick = uint64_t;
+
+  static constexpr unsigned SLOT_BITS = 6;
+  static constexpr unsigned N_SLOTS = 1 << SLOT_BITS;
+  static constexpr unsigned N_LEVELS = 4;
+  static constexpr Tick MAX_DELTA = (Tick(1) << (SLOT_BITS * N_LEVELS)) - 1;
+  static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+
+  enum class EntryState : uint8_t {
+    FREE,
+    LINKED,
+    FIRING,
+  };
+
+  struct Entry
+  {
+    Tick expiry = 0;
+    TimerCallback callback;
+    uint32_t generation = 0;
+    uint32_t prev = NIL;
+    uint32_t next = NIL;
+    uint8_t level = 0;
+    uint8_t slot = 0;
+    EntryState state = EntryState::FREE;
+  };
+
+  struct Level
+  {
+    Level()
+    {
+      heads.fill(NIL);
+    }
+
+    std::array<uint32_t, N_SLOTS> heads;
+    uint64_t occupied = 0;
+  };
+
+  /// @brief Get the tick at the current time, rounded down
+  Tick
+  getCurrentTick() const;
+
+  /// @brief Insert an entry in the slot matching its expiry
+  void
+  link(uint32_t index);
+
+  /// @brief Remove an entry from its slot
+  void
+  unlink(uint32_t index);
+
+  /// @brief Detach all entries of a slot, returning the head of the list
+  uint32_t
+  detach(unsigned level, unsigned slot);
+
+  void
+  release(uint32_t index);
+
+  /**
+   * @brief Find the next tick at which some slot must be processed
+   * @returns false if the wheel is empty
+   */
+  bool
+  findNextTick(Tick& tick) const;
+
+  /// @brief Process all slots due at tick, collecting expired timers
+  void
+  processTick(Tick tick, std::vector<TimerId>& expired);
+
+  /// @brief Make sure the scheduler wakes us up no later than tick
+  void
+  arm(Tick tick);
+
+  void
+  onWakeup();
+
+  static TimerId
+  makeId(uint32_t index, uint32_t generation)
+  {
+    return (TimerId(generation) << 32) | (index + 1);
+  }
+
+private:
+  ndn::Scheduler& m_scheduler;
+  const time::nanoseconds m_tick;
+  const time::steady_clock::TimePoint m_epoch;
+
+  // Last tick that was processed
+  Tick m_current = 0;
+
+  std::array<Level, N_LEVELS> m_levels;
+  std::vector<Entry> m_entries;
+  std::vector<uint32_t> m_freeList;
+  size_t m_nPending = 0;
+
+  scheduler::ScopedEventId m_wakeupEvent;
+  Tick m_wakeupTick = 0;
+  bool m_isArmed = false;
+};
+
+}  // namespace svs
+}  // namespace ndn
+
+#endif // NDN_SVS_TIMER_WHEEL_HPP
@@ -0,0 +1,48 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "timer.hpp"
+
+namespace ndn {
+namespace svs {
+
+const TimerBackend::TimerId TimerBackend::INVALID_TIMER = 0;
+
+TimerBackend::TimerId
+SchedulerTimerBackend::schedule(time::nanoseconds after, TimerCallback callback)
+{
+  TimerId id = ++m_lastId;
+  m_events[id] = m_scheduler.schedule(after, [this, id, callback] {
+    auto it = m_events.find(id);
+    if (it != m_events.end())
+    {
+      it->second.release();
+      m_events.erase(it);
+    }
+    callback();
+  });
+  return id;
+}
+
+void
+SchedulerTimerBackend::cancel(TimerId id)
+{
+  // Destroying the scoped handle cancels the event
+  m_events.erase(id);
+}
+
+}  // namespace svs
+}  // namespace ndn
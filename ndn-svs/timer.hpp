@@ -0,0 +1,91 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_TIMER_HPP
+#define NDN_SVS_TIMER_HPP
+
+#include "common.hpp"
+
+#include <unordered_map>
+
+namespace ndn {
+namespace svs {
+
+/**
+ * @brief Interface of the timer backend used by the sync logic
+ *
+ * All methods must be called from the thread running the io_service
+ * the backend is attached to.
+ */
+class TimerBackend : noncopyable
+{
+public:
+  using TimerId = uint64_t;
+  using TimerCallback = function<void()>;
+
+  virtual
+  ~TimerBackend() = default;
+
+  /**
+   * @brief Schedule a callback
+   *
+   * @param after Delay after which the callback is invoked
+   * @param callback The callback to invoke
+   * @returns an identifier that can be used to cancel the timer
+   */
+  virtual TimerId
+  schedule(time::nanoseconds after, TimerCallback callback) = 0;
+
+  /**
+   * @brief Cancel a pending timer
+   *
+   * Does nothing if the timer has already fired or was cancelled.
+   */
+  virtual void
+  cancel(TimerId id) = 0;
+
+public:
+  static const TimerId INVALID_TIMER;
+};
+
+/**
+ * @brief Timer backend that schedules every timer on an ndn::Scheduler
+ */
+class SchedulerTimerBackend : public TimerBackend
+{
+public:
+  explicit
+  SchedulerTimerBackend(ndn::Scheduler& scheduler)
+    : m_scheduler(scheduler)
+  {
+  }
+
+  TimerId
+  schedule(time::nanoseconds after, TimerCallback callback) override;
+
+  void
+  cancel(TimerId id) override;
+
+private:
+  ndn::Scheduler& m_scheduler;
+  std::unordered_map<TimerId, scheduler::ScopedEventId> m_events;
+  TimerId m_lastId = INVALID_TIMER;
+};
+
+}  // namespace svs
+}  // namespace ndn
+
+#endif // NDN_SVS_TIMER_HPP
@@ -0,0 +1,98 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "timing-policy.hpp"
+
+#include <cmath>
+
+namespace ndn {
+namespace svs {
+
+time::milliseconds
+TimingPolicy::getRetxDelay(size_t groupSize, ndn::random::RandomNumberEngine& rng)
+{
+  std::uniform_int_distribution<> dist(30000 * 0.9, 30000 * 1.1);
+  return time::milliseconds(dist(rng));
+}
+
+time::milliseconds
+TimingPolicy::getSuppressionDelay(size_t groupSize, ndn::random::RandomNumberEngine& rng)
+{
+  std::uniform_int_distribution<> dist(50 * 0.9, 50 * 1.1);
+  return time::milliseconds(dist(rng));
+}
+
+AdaptiveTimingPolicy::AdaptiveTimingPolicy()
+  : AdaptiveTimingPolicy(Options())
+{
+}
+
+AdaptiveTimingPolicy::AdaptiveTimingPolicy(const Options& options)
+  : m_options(options)
+  , m_lastActivity(time::steady_clock::now())
+{
+}
+
+time::milliseconds
+AdaptiveTimingPolicy::getRetxDelay(size_t groupSize, ndn::random::RandomNumberEngine& rng)
+{
+  // Stretch the period by the number of periods the group has been idle
+  double idle = time::duration_cast<time::milliseconds>(
+    time::steady_clock::now() - m_lastActivity).count();
+  double base = m_options.retxPeriod.count();
+  double stretch = std::max(1.0, std::min(m_options.maxIdleStretch, idle / base));
+
+  std::uniform_int_distribution<long> dist(base * stretch * 0.9, base * stretch * 1.1);
+  return time::milliseconds(dist(rng));
+}
+
+time::milliseconds
+AdaptiveTimingPolicy::getSuppressionDelay(size_t groupSize, ndn::random::RandomNumberEngine& rng)
+{
+  // Groups of up to four nodes get the base window
+  double groupScale = std::max(1.0, std::log2(std::max<size_t>(groupSize, 1)) - 1);
+  double base = m_options.suppressionPeriod.count();
+
+  double low = base * 0.9;
+  double high = std::min<double>(base * groupScale * m_suppressionScale * 1.1,
+                                 m_options.maxSuppressionPeriod.count());
+
+  std::uniform_int_distribution<long> dist(low, std::max(low, high));
+  return time::milliseconds(dist(rng));
+}
+
+void
+AdaptiveTimingPolicy::onActivity()
+{
+  m_lastActivity = time::steady_clock::now();
+}
+
+void
+AdaptiveTimingPolicy::onSuppressionEnd(size_t nRecorded)
+{
+  double maxScale = double(m_options.maxSuppressionPeriod.count()) /
+                    m_options.suppressionPeriod.count();
+
+  // Widen the window while others keep replying at the same time,
+  // and narrow it back when nobody else does
+  if (nRecorded > m_options.duplicateTarget)
+    m_suppressionScale = std::min(maxScale, m_suppressionScale * 1.5);
+  else if (nRecorded == 0)
+    m_suppressionScale = std::max(1.0, m_suppressionScale * 0.8);
+}
+
+}  // namespace svs
+}  // namespace ndn
@@ -0,0 +1,142 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_TIMING_POLICY_HPP
+#define NDN_SVS_TIMING_POLICY_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/util/random.hpp>
+
+namespace ndn {
+namespace svs {
+
+/**
+ * @brief Decides the timing of sync interests
+ *
+ * The base policy uses fixed periods: sync interests are retransmitted
+ * every 30s and outdated interests are answered after 50ms, both with
+ * 10% jitter.
+ */
+class TimingPolicy
+{
+public:
+  virtual
+  ~TimingPolicy() = default;
+
+  /**
+   * @brief Get the delay until the next periodic sync interest
+   *
+   * @param groupSize Number of nodes in the local version vector
+   * @param rng Random engine to draw jitter from
+   */
+  virtual time::milliseconds
+  getRetxDelay(size_t groupSize, ndn::random::RandomNumberEngine& rng);
+
+  /**
+   * @brief Get the delay before replying to an outdated sync interest
+   *
+   * @param groupSize Number of nodes in the local version vector
+   * @param rng Random engine to draw jitter from
+   */
+  virtual time::milliseconds
+  getSuppressionDelay(size_t groupSize, ndn::random::RandomNumberEngine& rng);
+
+  /**
+   * @brief Called when the state changes locally or through a peer,
+   * or when a peer is found to be outdated
+   */
+  virtual void
+  onActivity()
+  {
+  }
+
+  /**
+   * @brief Called when a suppression window ends
+   *
+   * @param nRecorded Number of sync interests received during the window,
+   *                  excluding the one that started it
+   */
+  virtual void
+  onSuppressionEnd(size_t nRecorded)
+  {
+  }
+};
+
+/**
+ * @brief Timing policy that adapts to the size and activity of the group
+ *
+ * The suppression window grows logarithmically with the group size, and
+ * is further scaled by a factor that increases while more than the target
+ * number of duplicate sync interests are seen in each window, and decays
+ * back when none are. This keeps the number of replies to each update
+ * roughly constant as the group grows.
+ *
+ * The retransmission period is stretched while the group is quiescent,
+ * up to maxIdleStretch times the base period, and reset on any activity.
+ */
+class AdaptiveTimingPolicy : public TimingPolicy
+{
+public:
+  struct Options
+  {
+    /** Base period of sync interest retransmission */
+    time::milliseconds retxPeriod = time::milliseconds(30000);
+    /** Maximum factor by which the retransmission period is stretched when idle */
+    double maxIdleStretch = 4;
+    /** Base delay before replying to an outdated sync interest */
+    time::milliseconds suppressionPeriod = time::milliseconds(50);
+    /** Upper bound for the suppression window */
+    time::milliseconds maxSuppressionPeriod = time::milliseconds(2000);
+    /** Number of duplicate sync interests per suppression window to aim for */
+    size_t duplicateTarget = 1;
+  };
+
+  AdaptiveTimingPolicy();
+
+  explicit
+  AdaptiveTimingPolicy(const Options& options);
+
+  time::milliseconds
+  getRetxDelay(size_t groupSize, ndn::random::RandomNumberEngine& rng) override;
+
+  time::milliseconds
+  getSuppressionDelay(size_t groupSize, ndn::random::RandomNumberEngine& rng) override;
+
+  void
+  onActivity() override;
+
+  void
+  onSuppressionEnd(size_t nRecorded) override;
+
+  /// @brief Get the current scale applied to the suppression window
+  double
+  getSuppressionScale() const
+  {
+    return m_suppressionScale;
+  }
+
+private:
+  const Options m_options;
+
+  double m_suppressionScale = 1;
+  time::steady_clock::TimePoint m_lastActivity;
+};
+
+}  // namespace svs
+}  // namespace ndn
+
+#endif // NDN_SVS_TIMING_POLICY_HPP
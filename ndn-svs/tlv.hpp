@@ -9,6 +9,14 @@ enum {
   VersionVector = 201,
   VersionVectorKey = 202,
   VersionVectorValue = 203,
+  PartitionedState = 204,
+  PartitionDigests = 205,
+  Partition = 206,
+  PartitionIndex = 207,
+  StateDigest = 208,
+  Reconcile = 209,
+  Ibf = 210,
+  InlineData = 211,
 };
 
 } // namespace tlv
@@ -0,0 +1,127 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+
+namespace ndn {
+namespace svs {
+namespace trace {
+
+std::ostream&
+operator<<(std::ostream& os, Event event)
+{
+  switch (event)
+  {
+    case Event::SYNC_RX:           return os << "sync-rx";
+    case Event::MERGE_RESULT:      return os << "merge-result";
+    case Event::SYNC_SUPPRESSED:   return os << "sync-suppressed";
+    case Event::SUPPRESSION_ENTER: return os << "suppression-enter";
+    case Event::TIMER_RESET:       return os << "timer-reset";
+    case Event::SYNC_TX:           return os << "sync-tx";
+    case Event::FETCH_TX:          return os << "fetch-tx";
+    case Event::FETCH_RX:          return os << "fetch-rx";
+    case Event::FETCH_RETRY:       return os << "fetch-retry";
+    case Event::FETCH_TIMEOUT:     return os << "fetch-timeout";
+  }
+  return os << "unknown";
+}
+
+#ifdef NDN_SVS_WITH_TRACING
+
+namespace {
+
+/**
+ * Single-writer ring; the owning thread publishes each record by
+ * advancing the head with release semantics.
+ */
+struct ThreadRing
+{
+  std::array<Record, RING_SIZE> records;
+  std::atomic<uint64_t> head{0};
+};
+
+std::mutex g_ringsMutex;
+std::vector<std::shared_ptr<ThreadRing>> g_rings;
+
+ThreadRing&
+getThreadRing()
+{
+  // Rings stay registered after their thread exits, for post-mortem collection
+  thread_local std::shared_ptr<ThreadRing> ring = [] {
+    auto newRing = std::make_shared<ThreadRing>();
+    std::lock_guard<std::mutex> lock(g_ringsMutex);
+    g_rings.push_back(newRing);
+    return newRing;
+  }();
+  return *ring;
+}
+
+} // namespace
+
+void
+record(Event event, const void* source, uint64_t arg0, uint64_t arg1)
+{
+  ThreadRing& ring = getThreadRing();
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+
+  auto now = time::steady_clock::now().time_since_epoch();
+  ring.records[head % RING_SIZE] = {
+    time::duration_cast<time::nanoseconds>(now).count(), source, event, arg0, arg1,
+  };
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+std::vector<Record>
+collect()
+{
+  std::vector<Record> records;
+
+  std::lock_guard<std::mutex> lock(g_ringsMutex);
+  for (const auto& ring : g_rings)
+  {
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+    uint64_t first = head > RING_SIZE ? head - RING_SIZE : 0;
+    for (uint64_t i = first; i < head; ++i)
+      records.push_back(ring->records[i % RING_SIZE]);
+  }
+
+  std::stable_sort(records.begin(), records.end(), [] (const Record& a, const Record& b) {
+    return a.time < b.time;
+  });
+  return records;
+}
+
+void
+print(std::ostream& os, const std::vector<Record>& records)
+{
+  for (const auto& r : records)
+  {
+    os << r.time << '\t' << r.source << '\t' << r.event << '\t'
+       << r.arg0 << '\t' << r.arg1 << '\n';
+  }
+}
+
+#endif // NDN_SVS_WITH_TRACING
+
+}  // namespace trace
+}  // namespace svs
+}  // namespace ndn
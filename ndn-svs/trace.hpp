@@ -0,0 +1,109 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_TRACE_HPP
+#define NDN_SVS_TRACE_HPP
+
+#include "common.hpp"
+
+#include <vector>
+
+namespace ndn {
+namespace svs {
+namespace trace {
+
+/**
+ * @brief Events traced on the sync and fetch paths
+ */
+enum class Event : uint8_t {
+  /** Sync interest received and validated; arg0 = number of entries */
+  SYNC_RX,
+  /** Received vector merged; arg0 = my vector newer, arg1 = other vector newer */
+  MERGE_RESULT,
+  /** Received sync interest recorded in suppression state */
+  SYNC_SUPPRESSED,
+  /** Entered suppression state; arg0 = reply delay in milliseconds */
+  SUPPRESSION_ENTER,
+  /** Retransmission timer reset; arg0 = delay in milliseconds */
+  TIMER_RESET,
+  /** Sync interest sent; arg0 = number of entries */
+  SYNC_TX,
+  /** Data interest expressed; arg0 = seq, arg1 = retries left */
+  FETCH_TX,
+  /** Data received for a fetch; arg0 = seq */
+  FETCH_RX,
+  /** Data interest retried after timeout or nack; arg0 = retries left */
+  FETCH_RETRY,
+  /** Fetch failed after all retries */
+  FETCH_TIMEOUT,
+};
+
+/**
+ * @brief One traced event
+ */
+struct Record
+{
+  /** Steady clock time in nanoseconds */
+  int64_t time;
+  /** Object that emitted the event */
+  const void* source;
+  Event event;
+  uint64_t arg0;
+  uint64_t arg1;
+};
+
+std::ostream&
+operator<<(std::ostream& os, Event event);
+
+#ifdef NDN_SVS_WITH_TRACING
+
+/// @brief Number of records kept per thread
+static const size_t RING_SIZE = 1 << 14;
+
+/**
+ * @brief Append a record to the ring buffer of the calling thread
+ *
+ * Does not lock or allocate, except on the first call on each thread.
+ */
+void
+record(Event event, const void* source, uint64_t arg0 = 0, uint64_t arg1 = 0);
+
+/**
+ * @brief Collect the records of all threads, ordered by time
+ *
+ * Records written concurrently with the collection may be torn;
+ * call after the traced activity stops for an exact timeline.
+ */
+std::vector<Record>
+collect();
+
+/// @brief Write records as one tab-separated line each
+void
+print(std::ostream& os, const std::vector<Record>& records);
+
+#define NDN_SVS_TRACE(...) ::ndn::svs::trace::record(__VA_ARGS__)
+
+#else
+
+#define NDN_SVS_TRACE(...) do {} while (false)
+
+#endif // NDN_SVS_WITH_TRACING
+
+}  // namespace trace
+}  // namespace svs
+}  // namespace ndn
+
+#endif // NDN_SVS_TRACE_HPP
@@ -17,6 +17,9 @@
 #include "version-vector.hpp"
 #include "tlv.hpp"
 
+#include <algorithm>
+#include <tuple>
+
 namespace ndn {
 namespace svs {
 
@@ -28,11 +31,15 @@ VersionVector::VersionVector(const ndn::Block& block) {
 
     if (key->type() != tlv::VersionVectorKey)
       NDN_THROW(Error("Expected VersionVectorKey"));
-    if (val->type() != tlv::VersionVectorValue)
+    if (val == block.elements_end() || val->type() != tlv::VersionVectorValue)
       NDN_THROW(Error("Expected VersionVectorValue"));
 
-    m_map[NodeID(reinterpret_cast<const char*>(it->value()), it->value_size())] =
-      SeqNo(ndn::encoding::readNonNegativeInteger(*val));
+    // Encoded vectors are sorted, so every entry goes at the end
+    m_map.emplace_hint(m_map.end(),
+                       std::piecewise_construct,
+                       std::forward_as_tuple(reinterpret_cast<const char*>(key->value()),
+                                             key->value_size()),
+                       std::forward_as_tuple(ndn::encoding::readNonNegativeInteger(*val)));
   }
 }
 
@@ -71,5 +78,142 @@ VersionVector::toStr() const
   return stream.str();
 }
 
+uint64_t
+VersionVector::getDigest() const
+{
+  if (!m_isDigestValid)
+  {
+    m_digest = 0;
+    for (const auto& entry : m_map)
+      m_digest += hashEntry(hashNode(entry.first), entry.second);
+    m_isDigestValid = true;
+  }
+  return m_digest;
+}
+
+VersionVector::VersionVector(const VersionVector& other)
+  : m_map(other.m_map)
+  , m_digest(other.m_digest)
+  , m_isDigestValid(other.m_isDigestValid)
+{
+  setPartitionCount(other.m_partitionCount);
+}
+
+VersionVector&
+VersionVector::operator=(const VersionVector& other)
+{
+  if (this != &other)
+  {
+    m_map = other.m_map;
+    m_digest = other.m_digest;
+    m_isDigestValid = other.m_isDigestValid;
+    setPartitionCount(other.m_partitionCount);
+  }
+  return *this;
+}
+
+void
+VersionVector::setPartitionCount(size_t count)
+{
+  m_partitionCount = std::max<size_t>(count, 1);
+  m_partitions.clear();
+  if (m_partitionCount == 1)
+    return;
+
+  m_partitions.resize(m_partitionCount);
+  for (const auto& entry : m_map)
+  {
+    uint64_t nodeHash = hashNode(entry.first);
+    auto& partition = m_partitions[getPartition(entry.first, m_partitionCount)];
+    partition.digest += hashEntry(nodeHash, entry.second);
+    partition.members.insert(&entry.first);
+  }
+}
+
+size_t
+VersionVector::getPartition(const NodeID& nid, size_t count)
+{
+  // Use the upper half, the lower one feeds the entry hash
+  return (hashNode(nid) >> 32) % count;
+}
+
+VersionVector
+VersionVector::getPartitionEntries(size_t partition) const
+{
+  VersionVector vv;
+  for (const NodeID* nid : m_partitions.at(partition).members)
+    vv.m_map.emplace_hint(vv.m_map.end(), *nid, get(*nid));
+  return vv;
+}
+
+uint64_t
+VersionVector::hashNode(const NodeID& nid)
+{
+  // FNV-1a
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (char c : nid)
+  {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+uint64_t
+VersionVector::hashEntry(uint64_t nodeHash, SeqNo seqNo)
+{
+  // splitmix64 finalizer over the combined value
+  uint64_t x = nodeHash ^ (seqNo * 0x9e3779b97f4a7c15ULL);
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+void
+VersionVector::updateDigests(const NodeID& nid, SeqNo seqNo)
+{
+  uint64_t nodeHash = hashNode(nid);
+  uint64_t entryHash = hashEntry(nodeHash, seqNo);
+
+  auto it = m_map.find(nid);
+  uint64_t oldHash = it != m_map.end() ? hashEntry(nodeHash, it->second) : 0;
+
+  if (m_isDigestValid)
+    m_digest += entryHash - oldHash;
+
+  if (m_partitionCount > 1)
+  {
+    auto& partition = m_partitions[(nodeHash >> 32) % m_partitionCount];
+    partition.digest += entryHash - oldHash;
+    if (it == m_map.end())
+    {
+      // Members point to the key in the map, so the entry is added here
+      it = m_map.emplace(nid, seqNo).first;
+      partition.members.insert(&it->first);
+    }
+  }
+}
+
+void
+VersionVector::removeFromDigests(const NodeID& nid)
+{
+  auto it = m_map.find(nid);
+  if (it == m_map.end())
+    return;
+
+  uint64_t nodeHash = hashNode(nid);
+  uint64_t oldHash = hashEntry(nodeHash, it->second);
+
+  if (m_isDigestValid)
+    m_digest -= oldHash;
+
+  if (m_partitionCount > 1)
+  {
+    auto& partition = m_partitions[(nodeHash >> 32) % m_partitionCount];
+    partition.digest -= oldHash;
+    partition.members.erase(&it->first);
+  }
+}
+
 } // namespace ndn
 } // namespace svs
@@ -20,6 +20,8 @@
 #include "common.hpp"
 
 #include <map>
+#include <set>
+#include <vector>
 
 #include <ndn-cxx/util/string-helper.hpp>
 
@@ -45,7 +47,16 @@ public:
 
   VersionVector() = default;
 
-  VersionVector(const VersionVector&) = default;
+  /** Copy, with partitions rebuilt over the entries of the copy */
+  VersionVector(const VersionVector& other);
+
+  VersionVector(VersionVector&&) = default;
+
+  VersionVector&
+  operator=(const VersionVector& other);
+
+  VersionVector&
+  operator=(VersionVector&&) = default;
 
   /** Decode a version vector from ndn::buffer */
   VersionVector(const ndn::Block& encoded);
@@ -59,14 +70,17 @@ public:
   toStr() const;
 
   SeqNo
-  set(NodeID nid, SeqNo seqNo)
+  set(const NodeID& nid, SeqNo seqNo)
   {
+    if (m_isDigestValid || m_partitionCount > 1)
+      updateDigests(nid, seqNo);
+
     m_map[nid] = seqNo;
     return seqNo;
   }
 
   SeqNo
-  get(NodeID nid) const
+  get(const NodeID& nid) const
   {
     auto elem = m_map.find(nid);
     return elem == m_map.end() ? 0 : elem->second;
@@ -85,12 +99,113 @@ public:
   }
 
   bool
-  has(NodeID nid) const
+  has(const NodeID& nid) const
   {
     return m_map.find(nid) != end();
   }
+
+  /// @brief Remove an entry, returning whether it existed
+  bool
+  remove(const NodeID& nid)
+  {
+    if (m_isDigestValid || m_partitionCount > 1)
+      removeFromDigests(nid);
+
+    return m_map.erase(nid) > 0;
+  }
+
+  /// @brief Get the number of entries
+  size_t
+  size() const
+  {
+    return m_map.size();
+  }
+
+  /**
+   * @brief Get the digest of the whole vector
+   *
+   * The digest is the sum of the hashes of all (NodeID, SeqNo) entries, and
+   * does not depend on the insertion order. It is computed on the first call,
+   * after which it is updated in O(1) as entries change.
+   */
+  uint64_t
+  getDigest() const;
+
+  /**
+   * @brief Split the entries into partitions by a hash of the node ID
+   *
+   * The digest and members of every partition are then kept up to date
+   * as entries change. A count of 1 disables partitioning.
+   */
+  void
+  setPartitionCount(size_t count);
+
+  size_t
+  getPartitionCount() const
+  {
+    return m_partitionCount;
+  }
+
+  /// @brief Get the partition of a node ID among count partitions
+  static size_t
+  getPartition(const NodeID& nid, size_t count);
+
+  /**
+   * @brief Get the digest of a partition
+   *
+   * The digest is the sum of the hashes of all (NodeID, SeqNo) entries
+   * in the partition, and does not depend on the insertion order.
+   */
+  uint64_t
+  getPartitionDigest(size_t partition) const
+  {
+    return m_partitions.at(partition).digest;
+  }
+
+  /// @brief Get the entries of a partition as a separate vector
+  VersionVector
+  getPartitionEntries(size_t partition) const;
+
+  /// @brief Hash a node ID, stable across hosts
+  static uint64_t
+  hashNode(const NodeID& nid);
+
+  /// @brief Hash an entry from the hash of its node ID
+  static uint64_t
+  hashEntry(uint64_t nodeHash, SeqNo seqNo);
+
 private:
+  void
+  updateDigests(const NodeID& nid, SeqNo seqNo);
+
+  void
+  removeFromDigests(const NodeID& nid);
+
+private:
+  struct NodeIdPtrLess
+  {
+    bool
+    operator()(const NodeID* a, const NodeID* b) const
+    {
+      return *a < *b;
+    }
+  };
+
+  struct Partition
+  {
+    uint64_t digest = 0;
+    // Keys of m_map, which stay valid until their entry is removed
+    std::set<const NodeID*, NodeIdPtrLess> members;
+  };
+
   std::map<NodeID, SeqNo> m_map;
+
+  // Maintained once requested; vectors decoded from the wire do not pay for it
+  mutable uint64_t m_digest = 0;
+  mutable bool m_isDigestValid = false;
+
+  size_t m_partitionCount = 1;
+  std::vector<Partition> m_partitions;
 };
 
 } // namespace ndn
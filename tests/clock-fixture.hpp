@@ -0,0 +1,72 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#ifndef NDN_SVS_TESTS_CLOCK_FIXTURE_HPP
+#define NDN_SVS_TESTS_CLOCK_FIXTURE_HPP
+
+#include <ndn-cxx/util/time-unit-test-clock.hpp>
+
+#include <boost/asio/io_service.hpp>
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+/**
+ * @brief Fixture that replaces the system and steady clocks with
+ * manually advanced clocks, and polls an io_service as time passes
+ */
+class ClockFixture
+{
+public:
+  ClockFixture()
+    : m_steadyClock(make_shared<time::UnitTestSteadyClock>())
+    , m_systemClock(make_shared<time::UnitTestSystemClock>())
+  {
+    time::setCustomClocks(m_steadyClock, m_systemClock);
+  }
+
+  ~ClockFixture()
+  {
+    time::setCustomClocks(nullptr, nullptr);
+  }
+
+  /// @brief Advance the clocks by nTicks steps of tick, polling after each step
+  void
+  advanceClocks(time::nanoseconds tick, size_t nTicks = 1)
+  {
+    for (size_t i = 0; i < nTicks; ++i)
+    {
+      m_steadyClock->advance(tick);
+      m_systemClock->advance(tick);
+
+      if (m_io.stopped())
+        m_io.reset();
+      m_io.poll();
+    }
+  }
+
+protected:
+  shared_ptr<time::UnitTestSteadyClock> m_steadyClock;
+  shared_ptr<time::UnitTestSystemClock> m_systemClock;
+  boost::asio::io_service m_io;
+};
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
+
+#endif // NDN_SVS_TESTS_CLOCK_FIXTURE_HPP
@@ -0,0 +1,126 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "cache-policy.hpp"
+
+#include "tests/boost-test.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+struct TestCachePolicyFixture
+{
+  TestCachePolicyFixture()
+    : keyChain("pib-memory:", "tpm-memory:")
+  {
+  }
+
+  Data
+  makeData(const Name& name, size_t size = 10,
+           time::milliseconds freshness = time::milliseconds(1000))
+  {
+    Data data(name);
+    data.setContent(std::vector<uint8_t>(size, 0).data(), size);
+    data.setFreshnessPeriod(freshness);
+    keyChain.sign(data, security::signingWithSha256());
+    return data;
+  }
+
+  KeyChain keyChain;
+  CachePolicy policy;
+  std::vector<Name> evicted;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestCachePolicy, TestCachePolicyFixture)
+
+BOOST_AUTO_TEST_CASE(AdmitAll)
+{
+  BOOST_CHECK(policy.admit(makeData("/a/1"), evicted));
+  BOOST_CHECK(policy.admit(makeData("/a/2"), evicted));
+  BOOST_CHECK(!policy.admit(makeData("/a/2"), evicted));
+  BOOST_CHECK_EQUAL(policy.size(), 2);
+  BOOST_CHECK(evicted.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Popularity)
+{
+  policy.setMinRequests(2);
+
+  policy.onRequest("/a/1");
+  BOOST_CHECK(!policy.admit(makeData("/a/1"), evicted));
+
+  policy.onRequest("/a/1");
+  BOOST_CHECK_EQUAL(policy.getRequests("/a/1"), 2);
+  BOOST_CHECK(policy.admit(makeData("/a/1"), evicted));
+  BOOST_CHECK_EQUAL(policy.getRequests("/a/1"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RequestAging)
+{
+  for (int i = 0; i < 3; ++i)
+    policy.onRequest("/popular");
+  for (size_t i = 0; i < CachePolicy::MAX_TRACKED_REQUESTS; ++i)
+    policy.onRequest(Name("/once").appendNumber(i));
+
+  BOOST_CHECK_EQUAL(policy.getRequests("/popular"), 1);
+  BOOST_CHECK_EQUAL(policy.getRequests(Name("/once").appendNumber(0)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Criteria)
+{
+  policy.setMaxPacketSize(200);
+  policy.setMinFreshness(time::milliseconds(500));
+  policy.setAdmissionFilter([] (const Data& data) {
+    return Name("/a").isPrefixOf(data.getName());
+  });
+
+  BOOST_CHECK(!policy.admit(makeData("/a/1", 500), evicted));
+  BOOST_CHECK(!policy.admit(makeData("/a/2", 10, time::milliseconds(100)), evicted));
+  BOOST_CHECK(!policy.admit(makeData("/b/1"), evicted));
+  BOOST_CHECK(policy.admit(makeData("/a/3"), evicted));
+}
+
+BOOST_AUTO_TEST_CASE(ByteBudget)
+{
+  Data d1 = makeData("/a/1", 100);
+  size_t size = d1.wireEncode().size();
+  policy.setByteBudget(size * 2);
+
+  BOOST_CHECK(policy.admit(d1, evicted));
+  BOOST_CHECK(policy.admit(makeData("/a/2", 100), evicted));
+  BOOST_CHECK_EQUAL(policy.getBytes(), size * 2);
+
+  // /a/1 was used more recently, so /a/2 goes
+  policy.onHit("/a/1");
+  BOOST_CHECK(policy.admit(makeData("/a/3", 100), evicted));
+  BOOST_REQUIRE_EQUAL(evicted.size(), 1);
+  BOOST_CHECK_EQUAL(evicted[0], "/a/2");
+  BOOST_CHECK_EQUAL(policy.size(), 2);
+
+  // Larger than the whole budget
+  evicted.clear();
+  BOOST_CHECK(!policy.admit(makeData("/a/4", 1000), evicted));
+  BOOST_CHECK(evicted.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
@@ -0,0 +1,99 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "delivery-tracker.hpp"
+
+#include "tests/boost-test.hpp"
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+struct TestDeliveryTrackerFixture
+{
+  DeliveryTracker tracker;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestDeliveryTracker, TestDeliveryTrackerFixture)
+
+BOOST_AUTO_TEST_CASE(Watermark)
+{
+  BOOST_CHECK_EQUAL(tracker.getWatermark("a"), 0);
+
+  BOOST_CHECK(tracker.markDelivered("a", 2));
+  BOOST_CHECK_EQUAL(tracker.getWatermark("a"), 0);
+  BOOST_CHECK(!tracker.isDelivered("a", 1));
+
+  BOOST_CHECK(tracker.markDelivered("a", 1));
+  BOOST_CHECK(!tracker.markDelivered("a", 1));
+  BOOST_CHECK_EQUAL(tracker.getWatermark("a"), 2);
+  BOOST_CHECK_EQUAL(tracker.getIntervalCount("a"), 1);
+  BOOST_CHECK_EQUAL(tracker.getWatermark("b"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Intervals)
+{
+  tracker.markDelivered("a", 1);
+  tracker.markDelivered("a", 5);
+  tracker.markDelivered("a", 9);
+  BOOST_CHECK_EQUAL(tracker.getIntervalCount("a"), 3);
+
+  // Bridges the intervals of 5 and 9
+  tracker.markSkipped("a", 4, 10);
+  BOOST_CHECK_EQUAL(tracker.getIntervalCount("a"), 2);
+  BOOST_CHECK(tracker.isDelivered("a", 7));
+  BOOST_CHECK(!tracker.isDelivered("a", 3));
+  BOOST_CHECK(!tracker.isDelivered("a", 11));
+  BOOST_CHECK(!tracker.markDelivered("a", 10));
+
+  tracker.markSkipped("a", 2, 3);
+  BOOST_CHECK_EQUAL(tracker.getIntervalCount("a"), 1);
+  BOOST_CHECK_EQUAL(tracker.getWatermark("a"), 10);
+}
+
+BOOST_AUTO_TEST_CASE(Gaps)
+{
+  tracker.setKnown("a", 10);
+  tracker.markDelivered("a", 1);
+  tracker.markDelivered("a", 4);
+  tracker.markDelivered("a", 5);
+  tracker.setKnown("b", 2);
+  tracker.markSkipped("b", 1, 2);
+  tracker.setKnown("c", 3);
+  tracker.setKnown("c", 1);
+
+  auto gaps = tracker.getGaps();
+  BOOST_REQUIRE_EQUAL(gaps.size(), 3);
+  BOOST_CHECK_EQUAL(gaps[0].session, "a");
+  BOOST_CHECK_EQUAL(gaps[0].low, 2);
+  BOOST_CHECK_EQUAL(gaps[0].high, 3);
+  BOOST_CHECK_EQUAL(gaps[1].session, "a");
+  BOOST_CHECK_EQUAL(gaps[1].low, 6);
+  BOOST_CHECK_EQUAL(gaps[1].high, 10);
+  BOOST_CHECK_EQUAL(gaps[2].session, "c");
+  BOOST_CHECK_EQUAL(gaps[2].low, 1);
+  BOOST_CHECK_EQUAL(gaps[2].high, 3);
+
+  tracker.erase("a");
+  BOOST_CHECK_EQUAL(tracker.getKnown("a"), 0);
+  BOOST_CHECK_EQUAL(tracker.getGaps().size(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
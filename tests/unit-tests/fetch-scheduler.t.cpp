@@ -0,0 +1,139 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "fetch-scheduler.hpp"
+
+#include "tests/boost-test.hpp"
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+struct TestFetchSchedulerFixture
+{
+  /// @brief Queue a fetch that records its start and holds its slot until completed
+  void
+  enqueue(const NodeID& nid, int seq)
+  {
+    scheduler.enqueue(nid, [this, nid, seq] (const FetchScheduler::DoneCallback& done) {
+      started.push_back(nid + std::to_string(seq));
+      pending.push_back(done);
+    });
+  }
+
+  /// @brief Complete the oldest fetch in flight
+  void
+  complete()
+  {
+    auto done = pending.front();
+    pending.pop_front();
+    done();
+  }
+
+  FetchScheduler scheduler;
+  std::vector<std::string> started;
+  std::deque<FetchScheduler::DoneCallback> pending;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestFetchScheduler, TestFetchSchedulerFixture)
+
+BOOST_AUTO_TEST_CASE(Unlimited)
+{
+  for (int i = 1; i <= 3; ++i)
+    enqueue("a", i);
+
+  BOOST_CHECK_EQUAL(started.size(), 3);
+  BOOST_CHECK_EQUAL(scheduler.getInFlight(), 3);
+  BOOST_CHECK_EQUAL(scheduler.getQueued(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RoundRobin)
+{
+  scheduler.setMaxConcurrent(1);
+
+  // A large backlog from a queued first, then a small one from b
+  for (int i = 1; i <= 5; ++i)
+    enqueue("a", i);
+  enqueue("b", 1);
+  enqueue("b", 2);
+
+  BOOST_CHECK_EQUAL(scheduler.getInFlight(), 1);
+  BOOST_CHECK_EQUAL(scheduler.getQueued(), 6);
+
+  while (!pending.empty())
+    complete();
+
+  std::vector<std::string> expected{"a1", "a2", "b1", "a3", "b2", "a4", "a5"};
+  BOOST_CHECK_EQUAL_COLLECTIONS(started.begin(), started.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(scheduler.getInFlight(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Priority)
+{
+  scheduler.setMaxConcurrent(1);
+  scheduler.setPriority("b", 3);
+  BOOST_CHECK_EQUAL(scheduler.getPriority("a"), 1);
+  BOOST_CHECK_EQUAL(scheduler.getPriority("b"), 3);
+
+  enqueue("a", 0);
+  for (int i = 1; i <= 3; ++i)
+    enqueue("a", i);
+  for (int i = 1; i <= 4; ++i)
+    enqueue("b", i);
+
+  while (!pending.empty())
+    complete();
+
+  std::vector<std::string> expected{"a0", "a1", "b1", "b2", "b3", "a2", "b4", "a3"};
+  BOOST_CHECK_EQUAL_COLLECTIONS(started.begin(), started.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrencyCap)
+{
+  scheduler.setMaxConcurrent(2);
+  for (int i = 1; i <= 5; ++i)
+    enqueue("a", i);
+  BOOST_CHECK_EQUAL(scheduler.getInFlight(), 2);
+
+  complete();
+  BOOST_CHECK_EQUAL(scheduler.getInFlight(), 2);
+  BOOST_CHECK_EQUAL(started.size(), 3);
+
+  // Raising the cap starts queued fetches
+  scheduler.setMaxConcurrent(0);
+  BOOST_CHECK_EQUAL(scheduler.getInFlight(), 4);
+  BOOST_CHECK_EQUAL(scheduler.getQueued(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SynchronousDone)
+{
+  scheduler.setMaxConcurrent(1);
+  size_t nFetched = 0;
+  for (int i = 0; i < 10; ++i)
+    scheduler.enqueue("a", [&] (const FetchScheduler::DoneCallback& done) {
+      ++nFetched;
+      done();
+    });
+
+  BOOST_CHECK_EQUAL(nFetched, 10);
+  BOOST_CHECK_EQUAL(scheduler.getInFlight(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
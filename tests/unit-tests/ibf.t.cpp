@@ -0,0 +1,105 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "ibf.hpp"
+#include "version-vector.hpp"
+
+#include "tests/boost-test.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+struct TestIbfFixture
+{
+  TestIbfFixture()
+    : a(InvertibleBloomFilter::getCellCount(10))
+    , b(InvertibleBloomFilter::getCellCount(10))
+  {
+    for (int i = 0; i < 1000; ++i)
+    {
+      uint64_t key = VersionVector::hashEntry(VersionVector::hashNode(std::to_string(i)), 1);
+      a.insert(key);
+      b.insert(key);
+    }
+  }
+
+  InvertibleBloomFilter a;
+  InvertibleBloomFilter b;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestIbf, TestIbfFixture)
+
+BOOST_AUTO_TEST_CASE(Difference)
+{
+  a.insert(111);
+  a.insert(222);
+  b.insert(333);
+  a.subtract(b);
+
+  std::vector<uint64_t> positive, negative;
+  BOOST_REQUIRE(a.decode(positive, negative));
+  std::sort(positive.begin(), positive.end());
+  BOOST_CHECK_EQUAL(positive.size(), 2);
+  BOOST_CHECK_EQUAL(positive[0], 111);
+  BOOST_CHECK_EQUAL(positive[1], 222);
+  BOOST_REQUIRE_EQUAL(negative.size(), 1);
+  BOOST_CHECK_EQUAL(negative[0], 333);
+}
+
+BOOST_AUTO_TEST_CASE(Equal)
+{
+  a.subtract(b);
+  std::vector<uint64_t> positive, negative;
+  BOOST_CHECK(a.decode(positive, negative));
+  BOOST_CHECK(positive.empty());
+  BOOST_CHECK(negative.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Overloaded)
+{
+  for (uint64_t i = 1; i <= 500; ++i)
+    a.insert(VersionVector::hashEntry(i, i));
+  a.subtract(b);
+
+  std::vector<uint64_t> positive, negative;
+  BOOST_CHECK(!a.decode(positive, negative));
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  a.erase(VersionVector::hashEntry(VersionVector::hashNode("1"), 1));
+  InvertibleBloomFilter decoded(a.encode());
+  BOOST_CHECK_EQUAL(decoded.getCellCount(), a.getCellCount());
+
+  b.subtract(decoded);
+  std::vector<uint64_t> positive, negative;
+  BOOST_REQUIRE(b.decode(positive, negative));
+  BOOST_REQUIRE_EQUAL(positive.size(), 1);
+  BOOST_CHECK_EQUAL(positive[0], VersionVector::hashEntry(VersionVector::hashNode("1"), 1));
+  BOOST_CHECK(negative.empty());
+
+  BOOST_CHECK_THROW(a.subtract(InvertibleBloomFilter(a.getCellCount() + 3)),
+                    InvertibleBloomFilter::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
@@ -15,8 +15,12 @@
  */
 
 #include "logic.hpp"
+#include "tlv.hpp"
 
 #include "tests/boost-test.hpp"
+#include "tests/clock-fixture.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
 
 namespace ndn {
 namespace svs {
@@ -36,17 +40,33 @@ struct TestLogicFixture
   Logic m_logic;
 
   std::vector<MissingDataInfo> missingData;
+  // SeqNos read back from the logic inside the update callback
+  std::vector<SeqNo> seqNosInUpdate;
 
   void
   update(const std::vector<MissingDataInfo>& v)
   {
     for (auto m : v)
+    {
       missingData.push_back(m);
+      seqNosInUpdate.push_back(m_logic.getSeqNo(m.session));
+    }
   }
 };
 
 BOOST_FIXTURE_TEST_SUITE(TestLogic, TestLogicFixture)
 
+BOOST_AUTO_TEST_CASE(UpdateCallbackUnlocked)
+{
+  // The callback reads the merged state without deadlocking
+  VersionVector v1;
+  v1.set("one", 4);
+  m_logic.mergeStateVector(v1);
+
+  BOOST_REQUIRE_EQUAL(seqNosInUpdate.size(), 1);
+  BOOST_CHECK_EQUAL(seqNosInUpdate[0], 4);
+}
+
 BOOST_AUTO_TEST_CASE(mergeStateVector)
 {
   VersionVector v = m_logic.getState();
@@ -84,6 +104,394 @@ BOOST_AUTO_TEST_CASE(mergeStateVector)
   BOOST_CHECK_EQUAL(missingData[0].high, 3);
 }
 
+BOOST_FIXTURE_TEST_CASE(SeededTiming, ClockFixture)
+{
+  // Time between the initial sync interest and its first retransmission
+  auto getRetxPeriod = [this] (uint32_t seed) {
+    KeyChain keyChain("pib-memory:", "tpm-memory:");
+    util::DummyClientFace face(m_io, keyChain, {true, true});
+    Logic logic(face, keyChain, "/ndn/test", [] (const std::vector<MissingDataInfo>&) {});
+    logic.seedRandom(seed);
+
+    std::vector<time::steady_clock::TimePoint> sent;
+    face.onSendInterest.connect([&sent] (const Interest& interest) {
+      if (Name("/ndn/test").isPrefixOf(interest.getName()))
+        sent.push_back(time::steady_clock::now());
+    });
+
+    for (int i = 0; i < 60000 && sent.size() < 2; ++i)
+      advanceClocks(time::milliseconds(1));
+
+    BOOST_REQUIRE_EQUAL(sent.size(), 2);
+    return sent[1] - sent[0];
+  };
+
+  auto period = getRetxPeriod(7);
+  BOOST_CHECK(period >= time::milliseconds(27000));
+  BOOST_CHECK(period <= time::milliseconds(33000));
+  BOOST_CHECK_EQUAL(getRetxPeriod(7), period);
+}
+
+BOOST_FIXTURE_TEST_CASE(PruneInactive, ClockFixture)
+{
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  util::DummyClientFace face(m_io, keyChain);
+  std::vector<MissingDataInfo> missingData;
+  Logic logic(face, keyChain, "/ndn/test", [&] (const std::vector<MissingDataInfo>& v) {
+    missingData.insert(missingData.end(), v.begin(), v.end());
+  }, SecurityOptions::DEFAULT, "self");
+  logic.setInactivityTimeout(time::seconds(10));
+
+  VersionVector v1;
+  v1.set("one", 1);
+  v1.set("two", 3);
+  logic.mergeStateVector(v1);
+  logic.updateSeqNo(1);
+
+  advanceClocks(time::seconds(6));
+  v1.set("one", 2);
+  logic.mergeStateVector(v1);
+
+  // "two" has not advanced for 12s, "self" is never pruned
+  advanceClocks(time::seconds(6));
+  logic.pruneInactive();
+  BOOST_CHECK_EQUAL(logic.getState().get("one"), 2);
+  BOOST_CHECK(!logic.getState().has("two"));
+  BOOST_CHECK_EQUAL(logic.getSeqNo(), 1);
+  BOOST_CHECK_EQUAL(logic.getMetrics().entriesPruned.get(), 1);
+
+  // Stale peers cannot bring the entry back
+  missingData.clear();
+  auto result = logic.mergeStateVector(v1);
+  BOOST_CHECK(!result.second);
+  BOOST_CHECK(!logic.getState().has("two"));
+  BOOST_CHECK(missingData.empty());
+
+  // New data from the member adds it back
+  v1.set("two", 5);
+  result = logic.mergeStateVector(v1);
+  BOOST_CHECK(result.second);
+  BOOST_CHECK_EQUAL(logic.getState().get("two"), 5);
+  BOOST_REQUIRE_EQUAL(missingData.size(), 1);
+  BOOST_CHECK_EQUAL(missingData[0].session, "two");
+  BOOST_CHECK_EQUAL(missingData[0].low, 4);
+  BOOST_CHECK_EQUAL(missingData[0].high, 5);
+}
+
+BOOST_FIXTURE_TEST_CASE(Partitioned, ClockFixture)
+{
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  util::DummyClientFace faceA(m_io, keyChain);
+  util::DummyClientFace faceB(m_io, keyChain);
+  std::vector<MissingDataInfo> missingA, missingB;
+  Logic logicA(faceA, keyChain, "/ndn/test", [&] (const std::vector<MissingDataInfo>& v) {
+    missingA.insert(missingA.end(), v.begin(), v.end());
+  }, SecurityOptions::DEFAULT, "a");
+  Logic logicB(faceB, keyChain, "/ndn/test", [&] (const std::vector<MissingDataInfo>& v) {
+    missingB.insert(missingB.end(), v.begin(), v.end());
+  }, SecurityOptions::DEFAULT, "b");
+  logicA.setPartitionCount(8);
+  logicB.setPartitionCount(8);
+
+  auto getLastState = [] (util::DummyClientFace& face) {
+    BOOST_REQUIRE(!face.sentInterests.empty());
+    return PartitionedState(face.sentInterests.back().getName().get(-2));
+  };
+
+  // The first sync interest announces all partitions
+  logicA.updateSeqNo(1);
+  advanceClocks(time::milliseconds(1));
+  BOOST_CHECK_EQUAL(getLastState(faceA).getPartitions().size(), 8);
+
+  // Later ones only carry the partitions that changed
+  logicA.updateSeqNo(2);
+  advanceClocks(time::milliseconds(1));
+  auto state = getLastState(faceA);
+  BOOST_CHECK_EQUAL(state.getPartitionCount(), 8);
+  BOOST_REQUIRE_EQUAL(state.getPartitions().size(), 1);
+  BOOST_CHECK_EQUAL(state.getPartitions().begin()->first, VersionVector::getPartition("a", 8));
+
+  logicB.onSyncInterestValidated(faceA.sentInterests.back());
+  BOOST_CHECK_EQUAL(logicB.getSeqNo("a"), 2);
+  BOOST_REQUIRE_EQUAL(missingB.size(), 1);
+  BOOST_CHECK_EQUAL(missingB[0].session, "a");
+  BOOST_CHECK_EQUAL(missingB[0].low, 1);
+  BOOST_CHECK_EQUAL(missingB[0].high, 2);
+
+  // B has state that A lacks, so the digests differ and B replies
+  // with the differing partition after the suppression delay
+  logicB.updateSeqNo(1);
+  advanceClocks(time::milliseconds(1));
+  faceB.sentInterests.clear();
+  logicB.onSyncInterestValidated(faceA.sentInterests.back());
+  advanceClocks(time::milliseconds(10), 30);
+  state = getLastState(faceB);
+  BOOST_REQUIRE_EQUAL(state.getPartitions().size(), 1);
+  BOOST_CHECK_EQUAL(state.getPartitions().begin()->first, VersionVector::getPartition("b", 8));
+
+  logicA.onSyncInterestValidated(faceB.sentInterests.back());
+  BOOST_CHECK_EQUAL(logicA.getSeqNo("b"), 1);
+  BOOST_CHECK_EQUAL(missingA.size(), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(DigestSync, ClockFixture)
+{
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  util::DummyClientFace faceA(m_io, keyChain);
+  util::DummyClientFace faceB(m_io, keyChain);
+  auto onUpdate = [] (const std::vector<MissingDataInfo>&) {};
+  Logic logicA(faceA, keyChain, "/ndn/test", onUpdate, SecurityOptions::DEFAULT, "a");
+  Logic logicB(faceB, keyChain, "/ndn/test", onUpdate, SecurityOptions::DEFAULT, "b");
+  logicA.setDigestSync(true);
+  logicB.setDigestSync(true);
+
+  auto getLastStateType = [] (util::DummyClientFace& face) {
+    BOOST_REQUIRE(!face.sentInterests.empty());
+    return face.sentInterests.back().getName().get(-2).type();
+  };
+
+  // New state always goes out as a full vector
+  logicA.updateSeqNo(1);
+  advanceClocks(time::milliseconds(1));
+  BOOST_CHECK_EQUAL(getLastStateType(faceA), tlv::VersionVector);
+
+  // After hearing the same state, only the digest is sent
+  logicB.onSyncInterestValidated(faceA.sentInterests.back());
+  logicB.sendSyncInterest();
+  advanceClocks(time::milliseconds(1));
+  BOOST_CHECK_EQUAL(getLastStateType(faceB), tlv::StateDigest);
+
+  logicA.onSyncInterestValidated(faceB.sentInterests.back());
+  logicA.sendSyncInterest();
+  advanceClocks(time::milliseconds(1));
+  BOOST_CHECK_EQUAL(getLastStateType(faceA), tlv::StateDigest);
+  BOOST_CHECK_EQUAL(logicA.getMetrics().syncDigestMismatches.get(), 0);
+
+  // A differing digest is answered with the full vector
+  Name syncName("/ndn/test");
+  syncName.append(Name::Component(encoding::makeNonNegativeIntegerBlock(tlv::StateDigest, 12345)))
+          .appendNumber(0);
+  logicA.onSyncInterestValidated(Interest(syncName));
+  BOOST_CHECK_EQUAL(logicA.getMetrics().syncDigestMismatches.get(), 1);
+
+  size_t nSent = faceA.sentInterests.size();
+  advanceClocks(time::milliseconds(10), 30);
+  BOOST_CHECK_EQUAL(faceA.sentInterests.size(), nSent + 1);
+  BOOST_CHECK_EQUAL(getLastStateType(faceA), tlv::VersionVector);
+}
+
+BOOST_FIXTURE_TEST_CASE(Reconcile, ClockFixture)
+{
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  util::DummyClientFace faceA(m_io, keyChain);
+  util::DummyClientFace faceB(m_io, keyChain);
+  auto onUpdate = [] (const std::vector<MissingDataInfo>&) {};
+  Logic logicA(faceA, keyChain, "/ndn/test", onUpdate, SecurityOptions::DEFAULT, "a");
+  Logic logicB(faceB, keyChain, "/ndn/test", onUpdate, SecurityOptions::DEFAULT, "b");
+  for (auto logic : {&logicA, &logicB})
+  {
+    logic->setDigestSync(true);
+    logic->setReconciliation(10);
+  }
+
+  // Large common state, a few entries only known to either side
+  VersionVector common;
+  for (int i = 0; i < 1000; ++i)
+    common.set("node-" + std::to_string(i), 5);
+  logicA.mergeStateVector(common);
+  logicB.mergeStateVector(common);
+
+  VersionVector onlyA, onlyB;
+  onlyA.set("node-1", 7);
+  onlyA.set("node-a", 1);
+  onlyB.set("node-2", 9);
+  onlyB.set("node-b", 3);
+  logicA.mergeStateVector(onlyA);
+  logicB.mergeStateVector(onlyB);
+
+  auto deliver = [this] (util::DummyClientFace& from, Logic& to) {
+    // Reconcile messages go out after the suppression delay
+    for (int i = 0; i < 200 && from.sentInterests.empty(); ++i)
+      advanceClocks(time::milliseconds(1));
+    BOOST_REQUIRE(!from.sentInterests.empty());
+    auto interest = from.sentInterests.back();
+    from.sentInterests.clear();
+    BOOST_CHECK_EQUAL(interest.getName().get(-2).type(), tlv::Reconcile);
+    BOOST_CHECK_LT(interest.wireEncode().size(), 1000);
+    to.onSyncInterestValidated(interest);
+  };
+
+  // A hears a differing digest and sends its filter
+  Name syncName("/ndn/test");
+  syncName.append(Name::Component(encoding::makeNonNegativeIntegerBlock(
+    tlv::StateDigest, logicB.getState().getDigest()))).appendNumber(0);
+  logicA.onSyncInterestValidated(Interest(syncName));
+
+  // B replies with its entries and filter, A with its entries
+  deliver(faceA, logicB);
+  deliver(faceB, logicA);
+  deliver(faceA, logicB);
+
+  BOOST_CHECK_EQUAL(logicA.getState().getDigest(), logicB.getState().getDigest());
+  BOOST_CHECK_EQUAL(logicA.getSeqNo("node-1"), 7);
+  BOOST_CHECK_EQUAL(logicB.getSeqNo("node-1"), 7);
+  BOOST_CHECK_EQUAL(logicA.getSeqNo("node-b"), 3);
+  BOOST_CHECK_EQUAL(logicB.getSeqNo("node-a"), 1);
+  BOOST_CHECK_EQUAL(logicA.getMetrics().reconcileFailures.get(), 0);
+
+  // Nothing left to send
+  advanceClocks(time::milliseconds(1), 200);
+  BOOST_CHECK(faceA.sentInterests.empty());
+  BOOST_CHECK(faceB.sentInterests.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(ReconcileSuppression, ClockFixture)
+{
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  util::DummyClientFace faceA(m_io, keyChain);
+  util::DummyClientFace faceB(m_io, keyChain);
+  auto onUpdate = [] (const std::vector<MissingDataInfo>&) {};
+  Logic logicA(faceA, keyChain, "/ndn/test", onUpdate, SecurityOptions::DEFAULT, "a");
+  Logic logicB(faceB, keyChain, "/ndn/test", onUpdate, SecurityOptions::DEFAULT, "b");
+
+  VersionVector common;
+  for (int i = 0; i < 100; ++i)
+    common.set("node-" + std::to_string(i), 5);
+  for (auto logic : {&logicA, &logicB})
+  {
+    logic->setDigestSync(true);
+    logic->setReconciliation(10);
+    logic->mergeStateVector(common);
+  }
+  advanceClocks(time::milliseconds(1));
+  faceA.sentInterests.clear();
+  faceB.sentInterests.clear();
+
+  // Both hear the same differing digest
+  Name syncName("/ndn/test");
+  syncName.append(Name::Component(encoding::makeNonNegativeIntegerBlock(
+    tlv::StateDigest, 12345))).appendNumber(0);
+  logicA.onSyncInterestValidated(Interest(syncName));
+  logicB.onSyncInterestValidated(Interest(syncName));
+
+  // Nothing is sent before the suppression delay
+  advanceClocks(time::milliseconds(1), 40);
+  BOOST_CHECK(faceA.sentInterests.empty());
+  BOOST_CHECK(faceB.sentInterests.empty());
+
+  // The first request goes out and covers the other one
+  for (int i = 0; i < 100 && faceA.sentInterests.empty() && faceB.sentInterests.empty(); ++i)
+    advanceClocks(time::milliseconds(1));
+  BOOST_REQUIRE_EQUAL(faceA.sentInterests.size() + faceB.sentInterests.size(), 1);
+  bool isFromA = !faceA.sentInterests.empty();
+  auto request = isFromA ? faceA.sentInterests.front() : faceB.sentInterests.front();
+  BOOST_CHECK_EQUAL(request.getName().get(-2).type(), tlv::Reconcile);
+  (isFromA ? logicB : logicA).onSyncInterestValidated(request);
+  faceA.sentInterests.clear();
+  faceB.sentInterests.clear();
+
+  // Equal states leave nothing to answer
+  advanceClocks(time::milliseconds(1), 200);
+  BOOST_CHECK(faceA.sentInterests.empty());
+  BOOST_CHECK(faceB.sentInterests.empty());
+  BOOST_CHECK_EQUAL(logicA.getMetrics().reconcileSent.get() +
+                    logicB.getMetrics().reconcileSent.get(), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(UpdateCallbackError, ClockFixture)
+{
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  util::DummyClientFace face(m_io, keyChain);
+  Logic logic(face, keyChain, "/ndn/test", [] (const std::vector<MissingDataInfo>&) {
+    NDN_THROW(ndn::tlv::Error("error in the application"));
+  }, SecurityOptions::DEFAULT, "a");
+
+  VersionVector entries;
+  entries.set("node-1", 3);
+  Block state(tlv::Reconcile);
+  state.push_back(entries.encode());
+  state.encode();
+  Name syncName("/ndn/test");
+  syncName.append(Name::Component(state)).appendNumber(0);
+
+  // Errors of the application are not taken for a malformed interest
+  BOOST_CHECK_THROW(logic.onSyncInterestValidated(Interest(syncName)), ndn::tlv::Error);
+  BOOST_CHECK_EQUAL(logic.getMetrics().syncInterestsMalformed.get(), 0);
+  BOOST_CHECK_EQUAL(logic.getSeqNo("node-1"), 3);
+
+  Block garbage(tlv::Reconcile);
+  garbage.push_back(encoding::makeNonNegativeIntegerBlock(tlv::VersionVector, 1));
+  garbage.encode();
+  Name malformedName("/ndn/test");
+  malformedName.append(Name::Component(garbage)).appendNumber(0);
+  logic.onSyncInterestValidated(Interest(malformedName));
+  BOOST_CHECK_EQUAL(logic.getMetrics().syncInterestsMalformed.get(), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(Recovery, ClockFixture)
+{
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  util::DummyClientFace faceA(m_io, keyChain);
+  util::DummyClientFace faceB(m_io, keyChain);
+  std::vector<MissingDataInfo> missingB;
+  Logic logicA(faceA, keyChain, "/ndn/test", [] (const std::vector<MissingDataInfo>&) {},
+               SecurityOptions::DEFAULT, "a");
+  Logic logicB(faceB, keyChain, "/ndn/test", [&] (const std::vector<MissingDataInfo>& v) {
+    missingB.insert(missingB.end(), v.begin(), v.end());
+  }, SecurityOptions::DEFAULT, "b");
+
+  // Enough state for several segments
+  VersionVector vv;
+  for (int i = 0; i < 2000; ++i)
+    vv.set("/some/long/node/prefix/" + std::to_string(i), i + 1);
+  logicA.mergeStateVector(vv);
+
+  // B resets, which announces the reset and fetches a snapshot
+  logicB.reset();
+  size_t nResets = 0;
+  Name segmentName;
+  for (int i = 0; i < 20; ++i)
+  {
+    advanceClocks(time::milliseconds(1));
+    for (const auto& interest : faceB.sentInterests)
+    {
+      if (interest.getName().get(2) == name::Component("reset"))
+        ++nResets;
+      else
+        logicA.onSyncInterest(interest);
+    }
+    faceB.sentInterests.clear();
+
+    advanceClocks(time::milliseconds(1));
+    for (const auto& data : faceA.sentData)
+    {
+      segmentName = data.getName();
+      faceB.receive(data);
+    }
+    faceA.sentData.clear();
+  }
+
+  BOOST_CHECK_GT(logicA.getMetrics().recoverySegmentsServed.get(), 1);
+  BOOST_CHECK_EQUAL(logicB.getMetrics().recoverySnapshotsFetched.get(), 1);
+  BOOST_CHECK_EQUAL(logicB.getState().size(), vv.size());
+  BOOST_CHECK_EQUAL(logicB.getSeqNo("/some/long/node/prefix/1999"), 2000);
+  BOOST_CHECK_EQUAL(missingB.size(), vv.size());
+  BOOST_CHECK_EQUAL(nResets, 1);
+
+  // Segments are named under the serving node, and not served for other nodes
+  BOOST_REQUIRE_EQUAL(segmentName.size(), 6);
+  BOOST_CHECK_EQUAL(segmentName.get(3), name::Component("a"));
+  BOOST_CHECK(segmentName.get(4).isVersion());
+
+  Name otherName("/ndn/test/recovery/b");
+  otherName.append(segmentName.get(4)).appendSegment(0);
+  logicA.onSyncInterest(Interest(otherName));
+  logicA.onSyncInterest(Interest(Name(segmentName.getPrefix(-1)).appendSegment(0)));
+  advanceClocks(time::milliseconds(1));
+  BOOST_REQUIRE_EQUAL(faceA.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(faceA.sentData.front().getName().get(3), name::Component("a"));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
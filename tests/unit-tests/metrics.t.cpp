@@ -0,0 +1,90 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "metrics.hpp"
+
+#include "tests/boost-test.hpp"
+
+#include <thread>
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+BOOST_AUTO_TEST_SUITE(TestMetrics)
+
+BOOST_AUTO_TEST_CASE(CounterGauge)
+{
+  Counter counter;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&] {
+      for (int j = 0; j < 1000; ++j)
+        counter.increment();
+    });
+  for (auto& thread : threads)
+    thread.join();
+  BOOST_CHECK_EQUAL(counter.get(), 4000);
+
+  Gauge gauge;
+  gauge.set(10);
+  gauge.add(-3);
+  BOOST_CHECK_EQUAL(gauge.get(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramQuantile)
+{
+  Histogram histogram;
+  for (uint64_t i = 1; i <= 100; ++i)
+    histogram.record(i);
+
+  auto s = histogram.snapshot();
+  BOOST_CHECK_EQUAL(s.count, 100);
+  BOOST_CHECK_EQUAL(s.sum, 5050);
+  BOOST_CHECK_EQUAL(s.mean(), 50.5);
+
+  // 50 is in [32, 64), 99 is in [64, 128)
+  BOOST_CHECK_EQUAL(s.quantile(0.5), 64);
+  BOOST_CHECK_EQUAL(s.quantile(0.99), 128);
+
+  BOOST_CHECK_EQUAL(Histogram().snapshot().quantile(0.5), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Export)
+{
+  LogicMetrics metrics;
+  metrics.syncInterestsSent.increment(3);
+  metrics.vectorSize.set(12);
+  metrics.mergeDuration.record(5);
+
+  MetricsSnapshot snapshot;
+  metrics.snapshot(snapshot);
+  BOOST_CHECK_EQUAL(snapshot.counters["sync_interests_sent"], 3);
+  BOOST_CHECK_EQUAL(snapshot.gauges["vector_size"], 12);
+  BOOST_CHECK_EQUAL(snapshot.histograms["merge_duration_us"].count, 1);
+
+  std::string text = snapshot.toStr();
+  BOOST_CHECK(text.find("svs_sync_interests_sent 3\n") != std::string::npos);
+  BOOST_CHECK(text.find("svs_vector_size 12\n") != std::string::npos);
+  BOOST_CHECK(text.find("svs_merge_duration_us_bucket{le=\"7\"} 1\n") != std::string::npos);
+  BOOST_CHECK(text.find("svs_merge_duration_us_count 1\n") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
@@ -0,0 +1,67 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "partitioned-state.hpp"
+#include "tlv.hpp"
+
+#include "tests/boost-test.hpp"
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+BOOST_AUTO_TEST_SUITE(TestPartitionedState)
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  VersionVector vv;
+  vv.setPartitionCount(4);
+  for (int i = 0; i < 20; ++i)
+    vv.set("node-" + std::to_string(i), i + 1);
+
+  size_t p = VersionVector::getPartition("node-3", 4);
+  PartitionedState state(vv, {p});
+  Block block = state.encode();
+  BOOST_CHECK_EQUAL(block.type(), tlv::PartitionedState);
+
+  PartitionedState decoded(block);
+  BOOST_CHECK_EQUAL(decoded.getPartitionCount(), 4);
+  for (size_t i = 0; i < 4; ++i)
+    BOOST_CHECK_EQUAL(decoded.getDigests()[i], vv.getPartitionDigest(i));
+
+  BOOST_REQUIRE_EQUAL(decoded.getPartitions().size(), 1);
+  const auto& entries = decoded.getPartitions().at(p);
+  BOOST_CHECK_EQUAL(entries.size(), vv.getPartitionEntries(p).size());
+  BOOST_CHECK_EQUAL(entries.get("node-3"), 4);
+}
+
+BOOST_AUTO_TEST_CASE(DecodeInvalid)
+{
+  // Digests not a multiple of 8 octets
+  const uint8_t digests[] = {0xCC, 0x05, 0xCD, 0x03, 0x01, 0x02, 0x03};
+  BOOST_CHECK_THROW(PartitionedState(Block(digests, sizeof(digests))), PartitionedState::Error);
+
+  // Partition index out of range
+  const uint8_t index[] = {0xCC, 0x11, 0xCD, 0x08, 0, 0, 0, 0, 0, 0, 0, 0,
+                           0xCE, 0x05, 0xCF, 0x01, 0x01, 0xC9, 0x00};
+  BOOST_CHECK_THROW(PartitionedState(Block(index, sizeof(index))), PartitionedState::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
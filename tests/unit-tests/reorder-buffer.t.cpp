@@ -0,0 +1,114 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "reorder-buffer.hpp"
+
+#include "tests/boost-test.hpp"
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+struct TestReorderBufferFixture
+{
+  TestReorderBufferFixture()
+    : buffer(4)
+  {
+  }
+
+  bool
+  insert(SeqNo seq)
+  {
+    return buffer.insert(seq, Data(Name("/a").appendNumber(seq)));
+  }
+
+  size_t
+  release()
+  {
+    return buffer.release([this] (const SeqNo& seq, const Data& data) {
+      BOOST_CHECK_EQUAL(data.getName().get(-1).toNumber(), seq);
+      released.push_back(seq);
+    });
+  }
+
+  ReorderBuffer buffer;
+  std::vector<SeqNo> released;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestReorderBuffer, TestReorderBufferFixture)
+
+BOOST_AUTO_TEST_CASE(InOrder)
+{
+  BOOST_CHECK(insert(3));
+  BOOST_CHECK(insert(2));
+  BOOST_CHECK(!insert(2));
+  BOOST_CHECK_EQUAL(release(), 0);
+  BOOST_CHECK_EQUAL(buffer.getFirst(), 2);
+
+  BOOST_CHECK(insert(1));
+  BOOST_CHECK_EQUAL(release(), 3);
+  BOOST_CHECK_EQUAL(buffer.getNext(), 4);
+  BOOST_CHECK_EQUAL(buffer.size(), 0);
+  BOOST_CHECK_EQUAL(buffer.getFirst(), 0);
+
+  std::vector<SeqNo> expected{1, 2, 3};
+  BOOST_CHECK_EQUAL_COLLECTIONS(released.begin(), released.end(), expected.begin(), expected.end());
+
+  // Already released
+  BOOST_CHECK(!insert(2));
+}
+
+BOOST_AUTO_TEST_CASE(Window)
+{
+  BOOST_CHECK(buffer.isInWindow(4));
+  BOOST_CHECK(!buffer.isInWindow(5));
+  BOOST_CHECK(!insert(5));
+  BOOST_CHECK(insert(4));
+
+  // The window moves as packets are released
+  BOOST_CHECK(insert(1));
+  release();
+  BOOST_CHECK(insert(5));
+  BOOST_CHECK(!buffer.has(8));
+  BOOST_CHECK(!insert(6 + buffer.getCapacity()));
+  BOOST_CHECK_EQUAL(buffer.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Skip)
+{
+  insert(2);
+  insert(4);
+  buffer.skipTo(2);
+  BOOST_CHECK_EQUAL(release(), 1);
+  BOOST_CHECK_EQUAL(buffer.getNext(), 3);
+
+  // Drops the packets skipped
+  buffer.skipTo(5);
+  BOOST_CHECK_EQUAL(buffer.size(), 0);
+  BOOST_CHECK_EQUAL(release(), 0);
+
+  insert(6);
+  buffer.skipTo(100);
+  BOOST_CHECK_EQUAL(buffer.getNext(), 100);
+  BOOST_CHECK_EQUAL(buffer.size(), 0);
+  BOOST_CHECK(insert(103));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
@@ -0,0 +1,613 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "socket.hpp"
+#include "socket-shared.hpp"
+
+#include "tests/boost-test.hpp"
+#include "tests/clock-fixture.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <algorithm>
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+struct TestSocketFixture : public ClockFixture
+{
+  TestSocketFixture()
+    : m_keyChain("pib-memory:", "tpm-memory:")
+    , m_faceA(m_io, m_keyChain, util::DummyClientFace::Options{true, true})
+    , m_faceB(m_io, m_keyChain, util::DummyClientFace::Options{true, true})
+    , m_socketA("/ndn/test", "a", m_faceA, [] (const std::vector<MissingDataInfo>&) {},
+                makeSecurityOptions())
+    , m_socketB("/ndn/test", "b", m_faceB, [this] (const std::vector<MissingDataInfo>& v) {
+                  m_missingB.insert(m_missingB.end(), v.begin(), v.end());
+                }, makeSecurityOptions())
+  {
+    advanceClocks(time::milliseconds(1));
+  }
+
+  static SecurityOptions
+  makeSecurityOptions()
+  {
+    SecurityOptions securityOptions;
+    securityOptions.dataSigningInfo = security::signingWithSha256();
+    return securityOptions;
+  }
+
+  /// @brief Deliver the data interests and data sent by each face to the other
+  void
+  exchange(size_t nRounds = 5)
+  {
+    for (size_t i = 0; i < nRounds; ++i)
+    {
+      auto interestsA = std::move(m_faceA.sentInterests);
+      auto interestsB = std::move(m_faceB.sentInterests);
+      auto dataA = std::move(m_faceA.sentData);
+      auto dataB = std::move(m_faceB.sentData);
+      m_faceA.sentInterests.clear();
+      m_faceB.sentInterests.clear();
+      m_faceA.sentData.clear();
+      m_faceB.sentData.clear();
+
+      for (const auto& interest : interestsA)
+        if (!Name("/ndn/test/s").isPrefixOf(interest.getName()))
+          m_faceB.receive(interest);
+      for (const auto& interest : interestsB)
+        if (!Name("/ndn/test/s").isPrefixOf(interest.getName()))
+          m_faceA.receive(interest);
+      for (const auto& data : dataA)
+        m_faceB.receive(data);
+      for (const auto& data : dataB)
+        m_faceA.receive(data);
+
+      advanceClocks(time::milliseconds(1));
+    }
+  }
+
+  KeyChain m_keyChain;
+  util::DummyClientFace m_faceA;
+  util::DummyClientFace m_faceB;
+  SocketShared m_socketA;
+  SocketShared m_socketB;
+
+  std::vector<MissingDataInfo> m_missingB;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestSocket, TestSocketFixture)
+
+BOOST_AUTO_TEST_CASE(DataName)
+{
+  BOOST_CHECK_EQUAL(m_socketA.getDataName("a", 5), Name("/ndn/test/d/a").appendNumber(5));
+  BOOST_CHECK_EQUAL(m_socketA.getDataName("a", 6), Name("/ndn/test/d/a").appendNumber(6));
+  BOOST_CHECK_EQUAL(m_socketA.getDataName("b", 1), Name("/ndn/test/d/b").appendNumber(1));
+
+  Socket socket("/ndn/test", "/node/c", m_faceA, [] (const std::vector<MissingDataInfo>&) {});
+  BOOST_CHECK_EQUAL(socket.getDataName("/node/c", 1), Name("/node/c/ndn/test").appendNumber(1));
+  BOOST_CHECK_EQUAL(socket.getDataName("/node/d", 2), Name("/node/d/ndn/test").appendNumber(2));
+  BOOST_CHECK_EQUAL(socket.getSnapshotPrefix("/node/d"), "/node/d/ndn/test/snapshot");
+}
+
+BOOST_AUTO_TEST_CASE(Snapshot)
+{
+  std::string state = "compacted state";
+  for (int i = 0; i < 5; ++i)
+    m_socketA.publishData(reinterpret_cast<const uint8_t*>(state.data()), state.size(),
+                          time::milliseconds(1000));
+  m_socketA.publishSnapshot(encoding::makeStringBlock(tlv::Content, state),
+                            time::milliseconds(1000));
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(state.data()), state.size(),
+                        time::milliseconds(1000));
+
+  BOOST_CHECK_EQUAL(m_socketA.getSnapshotPrefix("a"), "/ndn/test/d/a/snapshot");
+
+  SeqNo snapshotSeq = 0;
+  std::string snapshotContent;
+  m_socketB.fetchSnapshot("a", [&] (const Data& data, const SeqNo& seq) {
+    snapshotSeq = seq;
+    snapshotContent = readString(data.getContent());
+  }, [] (const Interest&) {
+    BOOST_ERROR("snapshot fetch timed out");
+  });
+  exchange();
+
+  BOOST_CHECK_EQUAL(snapshotSeq, 5);
+  BOOST_CHECK_EQUAL(snapshotContent, state);
+  BOOST_CHECK_EQUAL(m_socketA.getMetrics().snapshotsPublished.get(), 1);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().snapshotsFetched.get(), 1);
+
+  // Data packets are still served as before
+  bool isFetched = false;
+  m_socketB.fetchData("a", 6, [&] (const Data&) { isFetched = true; });
+  exchange();
+  BOOST_CHECK(isFetched);
+}
+
+BOOST_AUTO_TEST_CASE(SnapshotMissing)
+{
+  bool isTimedOut = false;
+  m_socketB.fetchSnapshot("a", [] (const Data&, const SeqNo&) {
+    BOOST_ERROR("unexpected snapshot");
+  }, [&] (const Interest&) {
+    isTimedOut = true;
+  });
+  exchange();
+  advanceClocks(time::milliseconds(100), 50);
+
+  BOOST_CHECK(isTimedOut);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().snapshotsFetched.get(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(LatestCount)
+{
+  m_socketB.setLatestCount(3);
+
+  VersionVector vv;
+  vv.set("a", 100);
+  vv.set("c", 2);
+  m_socketB.getLogic().mergeStateVector(vv);
+
+  BOOST_REQUIRE_EQUAL(m_missingB.size(), 2);
+  for (const auto& info : m_missingB)
+  {
+    if (info.session == "a")
+    {
+      BOOST_CHECK_EQUAL(info.low, 98);
+      BOOST_CHECK_EQUAL(info.high, 100);
+    }
+    else
+    {
+      BOOST_CHECK_EQUAL(info.low, 1);
+      BOOST_CHECK_EQUAL(info.high, 2);
+    }
+  }
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().updatesTrimmed.get(), 97);
+}
+
+BOOST_AUTO_TEST_CASE(TimeHorizon)
+{
+  m_socketB.setTimeHorizon(time::seconds(1));
+
+  // Never seen before: only the newest seqNo
+  VersionVector vv;
+  vv.set("a", 10);
+  m_socketB.getLogic().mergeStateVector(vv);
+  BOOST_REQUIRE_EQUAL(m_missingB.size(), 1);
+  BOOST_CHECK_EQUAL(m_missingB.back().low, 10);
+
+  // 100 seqNos in 10s, of which about 10 fall within the horizon
+  advanceClocks(time::seconds(10));
+  vv.set("a", 110);
+  m_socketB.getLogic().mergeStateVector(vv);
+  BOOST_REQUIRE_EQUAL(m_missingB.size(), 2);
+  BOOST_CHECK_EQUAL(m_missingB.back().low, 101);
+  BOOST_CHECK_EQUAL(m_missingB.back().high, 110);
+
+  // Everything since the last update is within the horizon
+  advanceClocks(time::milliseconds(500));
+  vv.set("a", 115);
+  m_socketB.getLogic().mergeStateVector(vv);
+  BOOST_REQUIRE_EQUAL(m_missingB.size(), 3);
+  BOOST_CHECK_EQUAL(m_missingB.back().low, 111);
+  BOOST_CHECK_EQUAL(m_missingB.back().high, 115);
+}
+
+BOOST_AUTO_TEST_CASE(FetchFromStore)
+{
+  std::string msg = "hello";
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(),
+                        time::milliseconds(1000));
+  advanceClocks(time::milliseconds(1));
+  m_faceA.sentInterests.clear();
+
+  // Own data is in the store
+  bool isFetched = false;
+  m_socketA.fetchData("a", 1, [&] (const Data& data) {
+    isFetched = true;
+    BOOST_CHECK_EQUAL(data.getName(), m_socketA.getDataName("a", 1));
+  });
+  BOOST_CHECK(!isFetched);
+  advanceClocks(time::milliseconds(1));
+
+  BOOST_CHECK(isFetched);
+  BOOST_CHECK(m_faceA.sentInterests.empty());
+  BOOST_CHECK_EQUAL(m_socketA.getMetrics().fetchStoreHits.get(), 1);
+  BOOST_CHECK_EQUAL(m_socketA.getMetrics().fetchInterestsSent.get(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ReplySuppression)
+{
+  m_socketB.setCacheAll(true);
+  std::string msg = "hello";
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(),
+                        time::milliseconds(1000));
+  m_socketB.fetchData("a", 1, [] (const Data&) {});
+  exchange();
+
+  Name name = m_socketA.getDataName("a", 1);
+  Interest interest(name);
+  interest.setCanBePrefix(false);
+  auto data = m_socketA.getDataStore().find(interest);
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_REQUIRE(m_socketB.getDataStore().find(interest) != nullptr);
+  m_faceA.sentData.clear();
+  m_faceB.sentData.clear();
+
+  // The producer answers right away
+  m_faceA.receive(interest);
+  advanceClocks(time::milliseconds(1));
+  BOOST_CHECK_EQUAL(m_faceA.sentData.size(), 1);
+
+  // Another member waits, and drops its reply once it hears the data
+  interest.refreshNonce();
+  m_faceB.receive(interest);
+  advanceClocks(time::milliseconds(1));
+  BOOST_CHECK(m_faceB.sentData.empty());
+  m_faceB.receive(*data);
+  advanceClocks(time::milliseconds(5), 10);
+  BOOST_CHECK(m_faceB.sentData.empty());
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().repliesSuppressed.get(), 1);
+
+  // Nobody else answers
+  interest.refreshNonce();
+  m_faceB.receive(interest);
+  advanceClocks(time::milliseconds(5), 10);
+  BOOST_CHECK_EQUAL(m_faceB.sentData.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ReplySuppressionListener)
+{
+  // Both members hold a fresh packet of a third node
+  Data data(m_socketA.getDataName("c", 1));
+  data.setFreshnessPeriod(time::seconds(1));
+  m_keyChain.sign(data, security::signingWithSha256());
+  m_socketA.getDataStore().insert(data);
+  m_socketB.getDataStore().insert(data);
+  m_socketA.setMaxReplyDelay(time::milliseconds(1));
+  m_faceA.sentInterests.clear();
+  m_faceB.sentInterests.clear();
+
+  Interest interest(data.getName());
+  interest.setCanBePrefix(false);
+  interest.setMustBeFresh(true);
+  m_faceA.receive(interest);
+  advanceClocks(time::microseconds(500));
+  interest.refreshNonce();
+  m_faceB.receive(interest);
+
+  // A answers first, and B drops its reply on hearing it
+  size_t nReplies = 0;
+  for (int i = 0; i < 200; ++i)
+  {
+    advanceClocks(time::microseconds(500));
+    for (const auto& reply : m_faceA.sentData)
+      m_faceB.receive(reply);
+    nReplies += m_faceA.sentData.size() + m_faceB.sentData.size();
+    m_faceA.sentData.clear();
+    m_faceB.sentData.clear();
+  }
+  BOOST_CHECK_EQUAL(nReplies, 1);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().repliesSuppressed.get(), 1);
+
+  // The listeners match the request and never leave the node
+  for (const auto* face : {&m_faceA, &m_faceB})
+  {
+    for (const auto& sent : face->sentInterests)
+    {
+      if (sent.getName() != data.getName())
+        continue;
+      BOOST_CHECK(sent.getMustBeFresh());
+      BOOST_CHECK(!sent.getCanBePrefix());
+      BOOST_REQUIRE(sent.getHopLimit());
+      BOOST_CHECK_EQUAL(static_cast<int>(*sent.getHopLimit()), 0);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(FetchFuture)
+{
+  std::string msg = "hello";
+  for (int i = 0; i < 3; ++i)
+    m_socketA.publishData(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(),
+                          time::milliseconds(1000));
+
+  auto futures = m_socketB.fetchRange("a", 1, 3);
+  auto missing = m_socketB.fetch("a", 4);
+  BOOST_REQUIRE_EQUAL(futures.size(), 3);
+  BOOST_CHECK(m_socketB.fetchRange("a", 3, 2).empty());
+  exchange();
+  advanceClocks(time::milliseconds(100), 50);
+
+  for (SeqNo seq = 1; seq <= 3; ++seq)
+  {
+    auto& future = futures[seq - 1];
+    BOOST_REQUIRE(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    BOOST_CHECK_EQUAL(future.get().getName(), m_socketA.getDataName("a", seq));
+  }
+
+  BOOST_REQUIRE(missing.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+  BOOST_CHECK_THROW(missing.get(), SocketBase::Error);
+}
+
+BOOST_AUTO_TEST_CASE(TrackedDelivery)
+{
+  std::vector<Name> delivered;
+  m_socketB.setDeliveryCallback([&] (const Data& data) {
+    delivered.push_back(data.getName());
+  }, time::milliseconds(500));
+
+  std::string msg = "hello";
+  for (int i = 0; i < 2; ++i)
+    m_socketA.publishData(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(),
+                          time::milliseconds(1000));
+
+  // Seq 3 is not published yet
+  VersionVector vv;
+  vv.set("a", 3);
+  m_socketB.getLogic().mergeStateVector(vv);
+  exchange();
+  BOOST_CHECK_EQUAL(delivered.size(), 2);
+  BOOST_CHECK_EQUAL(m_socketB.getDeliveredWatermark("a"), 2);
+
+  // The fetch of seq 3 times out and is retried
+  advanceClocks(time::milliseconds(100), 50);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().gapsRefetched.get(), 1);
+
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(),
+                        time::milliseconds(1000));
+  exchange();
+  BOOST_REQUIRE_EQUAL(delivered.size(), 3);
+  BOOST_CHECK_EQUAL(delivered.back(), m_socketA.getDataName("a", 3));
+  BOOST_CHECK_EQUAL(m_socketB.getDeliveredWatermark("a"), 3);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().fetchInterestsSent.get(), 4);
+
+  // Skipped seqNos are neither delivered nor fetched again
+  vv.set("a", 5);
+  m_socketB.getLogic().mergeStateVector(vv);
+  m_socketB.skipDelivery("a", 4, 5);
+  advanceClocks(time::milliseconds(100), 50);
+  BOOST_CHECK_EQUAL(m_socketB.getDeliveredWatermark("a"), 5);
+  BOOST_CHECK(m_socketB.getDeliveryTracker().getGaps().empty());
+  BOOST_CHECK_EQUAL(delivered.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(TrackedDeliveryAttempts)
+{
+  m_socketB.setDeliveryCallback([] (const Data&) {
+    BOOST_ERROR("unexpected delivery");
+  }, time::milliseconds(500), 2);
+
+  // The node never answers
+  VersionVector vv;
+  vv.set("a", 1);
+  m_socketB.getLogic().mergeStateVector(vv);
+  advanceClocks(time::milliseconds(100), 100);
+
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().fetchInterestsSent.get(), 2);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().gapsRefetched.get(), 1);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().deliverySkipped.get(), 1);
+  BOOST_CHECK_EQUAL(m_socketB.getDeliveredWatermark("a"), 1);
+  BOOST_CHECK(m_socketB.getDeliveryTracker().getGaps().empty());
+}
+
+BOOST_AUTO_TEST_CASE(OrderedDelivery)
+{
+  std::vector<SeqNo> delivered;
+  m_socketB.setDeliveryCallback([&] (const Data& data) {
+    delivered.push_back(data.getName().get(-1).toNumber());
+  });
+  m_socketB.setOrderedDelivery(2);
+  m_socketB.setHeadOfLineTimeout(time::seconds(1));
+
+  std::string msg = "hello";
+  for (int i = 0; i < 4; ++i)
+    m_socketA.publishData(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(),
+                          time::milliseconds(1000));
+
+  VersionVector vv;
+  vv.set("a", 4);
+  m_socketB.getLogic().mergeStateVector(vv);
+  advanceClocks(time::milliseconds(1));
+
+  // Only the window is fetched, and the interest for seq 1 is lost
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().fetchInterestsSent.get(), 2);
+  Name lost = m_socketA.getDataName("a", 1);
+  auto& sent = m_faceB.sentInterests;
+  sent.erase(std::remove_if(sent.begin(), sent.end(), [&] (const Interest& interest) {
+    return interest.getName() == lost;
+  }), sent.end());
+
+  exchange();
+  BOOST_CHECK(delivered.empty());
+
+  // Seq 1 is skipped, which moves the window
+  advanceClocks(time::milliseconds(100), 11);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().deliverySkipped.get(), 1);
+  exchange();
+
+  std::vector<SeqNo> expected{2, 3, 4};
+  BOOST_CHECK_EQUAL_COLLECTIONS(delivered.begin(), delivered.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(m_socketB.getDeliveredWatermark("a"), 4);
+}
+
+BOOST_AUTO_TEST_CASE(OrderedSkipOnLoss)
+{
+  std::vector<SeqNo> delivered;
+  m_socketB.setDeliveryCallback([&] (const Data& data) {
+    delivered.push_back(data.getName().get(-1).toNumber());
+  });
+  m_socketB.setOrderedDelivery(1);
+  m_socketB.setSkipOnLoss(true);
+
+  std::string msg = "hello";
+  for (int i = 0; i < 3; ++i)
+    m_socketA.publishData(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(),
+                          time::milliseconds(1000));
+
+  VersionVector vv;
+  vv.set("a", 3);
+  m_socketB.getLogic().mergeStateVector(vv);
+  advanceClocks(time::milliseconds(1));
+
+  // Seq 1 is lost before any packet of the node arrives
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().fetchInterestsSent.get(), 1);
+  m_faceB.sentInterests.clear();
+  advanceClocks(time::milliseconds(100), 45);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().deliverySkipped.get(), 1);
+
+  exchange();
+  std::vector<SeqNo> expected{2, 3};
+  BOOST_CHECK_EQUAL_COLLECTIONS(delivered.begin(), delivered.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(m_socketB.getDeliveredWatermark("a"), 3);
+}
+
+BOOST_AUTO_TEST_CASE(Subscribe)
+{
+  std::vector<Name> received;
+  m_socketB.subscribe("a", [&] (const Data& data) {
+    received.push_back(data.getName());
+  });
+  exchange();
+
+  // The interest is held by the producer until the data is published
+  BOOST_CHECK(received.empty());
+  std::string msg = "hello";
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(),
+                        time::milliseconds(1000));
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(),
+                        time::milliseconds(1000));
+  exchange();
+
+  BOOST_REQUIRE_EQUAL(received.size(), 2);
+  BOOST_CHECK_EQUAL(received[0], m_socketA.getDataName("a", 1));
+  BOOST_CHECK_EQUAL(received[1], m_socketA.getDataName("a", 2));
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().subscriptionData.get(), 2);
+
+  // Delivered seqNos are not reported again
+  VersionVector vv;
+  vv.set("a", 3);
+  m_socketB.getLogic().mergeStateVector(vv);
+  BOOST_REQUIRE_EQUAL(m_missingB.size(), 1);
+  BOOST_CHECK_EQUAL(m_missingB[0].low, 3);
+  BOOST_CHECK_EQUAL(m_missingB[0].high, 3);
+
+  m_socketB.unsubscribe("a");
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(msg.data()), msg.size(),
+                        time::milliseconds(1000));
+  exchange();
+  BOOST_CHECK_EQUAL(received.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(InlineData)
+{
+  m_socketA.setInlineThreshold(100);
+  std::vector<Name> inlineB;
+  m_socketB.setInlineDataCallback([&] (const Data& data) {
+    inlineB.push_back(data.getName());
+  });
+
+  std::string small = "hi";
+  std::string large(200, 'x');
+  m_faceA.sentInterests.clear();
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(small.data()), small.size(),
+                        time::milliseconds(1000));
+  advanceClocks(time::milliseconds(1));
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(large.data()), large.size(),
+                        time::milliseconds(1000));
+  advanceClocks(time::milliseconds(1));
+
+  BOOST_REQUIRE_EQUAL(m_faceA.sentInterests.size(), 2);
+  BOOST_CHECK(m_faceA.sentInterests[0].hasApplicationParameters());
+  BOOST_CHECK(!m_faceA.sentInterests[1].hasApplicationParameters());
+  for (const auto& interest : m_faceA.sentInterests)
+    m_faceB.receive(interest);
+  advanceClocks(time::milliseconds(1));
+
+  // The small packet needs no fetch, the large one is reported as usual
+  BOOST_REQUIRE_EQUAL(inlineB.size(), 1);
+  BOOST_CHECK_EQUAL(inlineB[0], m_socketA.getDataName("a", 1));
+  BOOST_REQUIRE_EQUAL(m_missingB.size(), 1);
+  BOOST_CHECK_EQUAL(m_missingB[0].low, 2);
+  BOOST_CHECK_EQUAL(m_missingB[0].high, 2);
+  BOOST_CHECK_EQUAL(m_socketB.getLogic().getSeqNo("a"), 2);
+  // Data of other nodes is not cached by default
+  BOOST_CHECK(m_socketB.getDataStore().find(Interest(m_socketA.getDataName("a", 1))) == nullptr);
+  BOOST_CHECK_EQUAL(m_socketA.getLogic().getMetrics().inlineDataSent.get(), 1);
+  BOOST_CHECK_EQUAL(m_socketB.getLogic().getMetrics().inlineDataReceived.get(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(InlineDataCacheAll)
+{
+  m_socketB.setCacheAll(true);
+  m_socketA.setInlineThreshold(100);
+
+  std::string small = "hi";
+  m_faceA.sentInterests.clear();
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(small.data()), small.size(),
+                        time::milliseconds(1000));
+  advanceClocks(time::milliseconds(1));
+  for (const auto& interest : m_faceA.sentInterests)
+    m_faceB.receive(interest);
+  advanceClocks(time::milliseconds(1));
+
+  BOOST_CHECK_EQUAL(m_socketB.getLogic().getMetrics().inlineDataReceived.get(), 1);
+  BOOST_CHECK(m_socketB.getDataStore().find(Interest(m_socketA.getDataName("a", 1))) != nullptr);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().storeInserts.get(), 1);
+
+  // The same packet heard again is not inserted again
+  for (const auto& interest : m_faceA.sentInterests)
+  {
+    Interest again(interest);
+    again.refreshNonce();
+    m_faceB.receive(again);
+  }
+  advanceClocks(time::milliseconds(1));
+  BOOST_CHECK_EQUAL(m_socketB.getLogic().getMetrics().inlineDataReceived.get(), 2);
+  BOOST_CHECK_EQUAL(m_socketB.getMetrics().storeInserts.get(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(InlineDataCachePolicy)
+{
+  auto policy = make_shared<CachePolicy>();
+  policy->setMinRequests(1);
+  m_socketB.setCacheAll(true);
+  m_socketB.setCachePolicy(policy);
+  m_socketA.setInlineThreshold(100);
+  m_socketB.setInlineDataCallback([] (const Data&) {});
+
+  std::string small = "hi";
+  m_faceA.sentInterests.clear();
+  m_socketA.publishData(reinterpret_cast<const uint8_t*>(small.data()), small.size(),
+                        time::milliseconds(1000));
+  advanceClocks(time::milliseconds(1));
+  for (const auto& interest : m_faceA.sentInterests)
+    m_faceB.receive(interest);
+  advanceClocks(time::milliseconds(1));
+
+  // Delivered, but never requested, so not admitted to the store
+  BOOST_CHECK_EQUAL(m_socketB.getLogic().getMetrics().inlineDataReceived.get(), 1);
+  BOOST_CHECK(m_socketB.getDataStore().find(Interest(m_socketA.getDataName("a", 1))) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
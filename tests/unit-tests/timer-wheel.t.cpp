@@ -0,0 +1,128 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "timer-wheel.hpp"
+
+#include "tests/boost-test.hpp"
+#include "tests/clock-fixture.hpp"
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+struct TestTimerWheelFixture : public ClockFixture
+{
+  TestTimerWheelFixture()
+    : m_scheduler(m_io)
+    , m_wheel(m_scheduler)
+  {
+  }
+
+  ndn::Scheduler m_scheduler;
+  TimerWheel m_wheel;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestTimerWheel, TestTimerWheelFixture)
+
+BOOST_AUTO_TEST_CASE(Fire)
+{
+  int nFired = 0;
+  m_wheel.schedule(time::milliseconds(50), [&] { ++nFired; });
+  BOOST_CHECK_EQUAL(m_wheel.size(), 1);
+
+  advanceClocks(time::milliseconds(10), 4);
+  BOOST_CHECK_EQUAL(nFired, 0);
+
+  advanceClocks(time::milliseconds(10));
+  BOOST_CHECK_EQUAL(nFired, 1);
+  BOOST_CHECK_EQUAL(m_wheel.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Cancel)
+{
+  int nFired = 0;
+  auto id = m_wheel.schedule(time::milliseconds(50), [&] { ++nFired; });
+  m_wheel.schedule(time::milliseconds(60), [&] { nFired += 10; });
+  m_wheel.cancel(id);
+  BOOST_CHECK_EQUAL(m_wheel.size(), 1);
+
+  advanceClocks(time::milliseconds(10), 10);
+  BOOST_CHECK_EQUAL(nFired, 10);
+
+  // Cancelling a fired or invalid timer is a no-op
+  m_wheel.cancel(id);
+  m_wheel.cancel(TimerBackend::INVALID_TIMER);
+  BOOST_CHECK_EQUAL(m_wheel.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(CancelFromCallback)
+{
+  int nFired = 0;
+  TimerBackend::TimerId second;
+  m_wheel.schedule(time::milliseconds(20), [&] { ++nFired; m_wheel.cancel(second); });
+  second = m_wheel.schedule(time::milliseconds(20), [&] { ++nFired; });
+
+  advanceClocks(time::milliseconds(30));
+  BOOST_CHECK_EQUAL(nFired, 1);
+}
+
+BOOST_AUTO_TEST_CASE(Cascade)
+{
+  std::vector<time::steady_clock::TimePoint> fired;
+  auto start = time::steady_clock::now();
+
+  // Delays covering every level of the wheel
+  std::vector<time::milliseconds> delays = {
+    time::milliseconds(5), time::milliseconds(300), time::milliseconds(27000),
+    time::milliseconds(33000), time::milliseconds(600000),
+  };
+  for (auto delay : delays)
+    m_wheel.schedule(delay, [&] { fired.push_back(time::steady_clock::now()); });
+
+  advanceClocks(time::milliseconds(5), 130000);
+  BOOST_REQUIRE_EQUAL(fired.size(), delays.size());
+
+  for (size_t i = 0; i < delays.size(); ++i)
+  {
+    BOOST_CHECK(fired[i] >= start + delays[i]);
+    BOOST_CHECK(fired[i] <= start + delays[i] + time::milliseconds(5));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Reschedule)
+{
+  // Emulates the sync logic resetting its retransmission timer
+  int nFired = 0;
+  auto id = m_wheel.schedule(time::milliseconds(30000), [&] { ++nFired; });
+  for (int i = 0; i < 100; ++i)
+  {
+    advanceClocks(time::milliseconds(100));
+    m_wheel.cancel(id);
+    id = m_wheel.schedule(time::milliseconds(30000), [&] { ++nFired; });
+  }
+  BOOST_CHECK_EQUAL(m_wheel.size(), 1);
+
+  advanceClocks(time::milliseconds(100), 299);
+  BOOST_CHECK_EQUAL(nFired, 0);
+  advanceClocks(time::milliseconds(100), 2);
+  BOOST_CHECK_EQUAL(nFired, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
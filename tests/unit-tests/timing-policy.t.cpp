@@ -0,0 +1,114 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "timing-policy.hpp"
+
+#include "tests/boost-test.hpp"
+#include "tests/clock-fixture.hpp"
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+struct TestTimingPolicyFixture : public ClockFixture
+{
+  TestTimingPolicyFixture()
+    : m_rng(42)
+  {
+  }
+
+  time::milliseconds
+  maxSuppressionDelay(size_t groupSize)
+  {
+    time::milliseconds delay(0);
+    for (int i = 0; i < 1000; ++i)
+      delay = std::max(delay, m_policy.getSuppressionDelay(groupSize, m_rng));
+    return delay;
+  }
+
+  ndn::random::RandomNumberEngine m_rng;
+  AdaptiveTimingPolicy m_policy;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestTimingPolicy, TestTimingPolicyFixture)
+
+BOOST_AUTO_TEST_CASE(Static)
+{
+  TimingPolicy policy;
+  for (int i = 0; i < 100; ++i)
+  {
+    auto retx = policy.getRetxDelay(1000, m_rng);
+    BOOST_CHECK(retx >= time::milliseconds(27000) && retx <= time::milliseconds(33000));
+
+    auto suppression = policy.getSuppressionDelay(1000, m_rng);
+    BOOST_CHECK(suppression >= time::milliseconds(45) && suppression <= time::milliseconds(55));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(GroupSize)
+{
+  // Small groups keep the base window
+  BOOST_CHECK(maxSuppressionDelay(4) <= time::milliseconds(55));
+
+  auto delay64 = maxSuppressionDelay(64);
+  auto delay512 = maxSuppressionDelay(512);
+  BOOST_CHECK(delay64 > time::milliseconds(200));
+  BOOST_CHECK(delay512 > delay64);
+
+  // Logarithmic, not linear, in the group size
+  BOOST_CHECK(delay512 < delay64 * 2);
+}
+
+BOOST_AUTO_TEST_CASE(Duplicates)
+{
+  auto before = maxSuppressionDelay(4);
+
+  for (int i = 0; i < 5; ++i)
+    m_policy.onSuppressionEnd(5);
+  BOOST_CHECK_GT(m_policy.getSuppressionScale(), 5);
+  BOOST_CHECK(maxSuppressionDelay(4) > before * 5);
+
+  // Quiet windows bring the scale back down
+  for (int i = 0; i < 50; ++i)
+    m_policy.onSuppressionEnd(0);
+  BOOST_CHECK_EQUAL(m_policy.getSuppressionScale(), 1);
+
+  // Never beyond the upper bound
+  for (int i = 0; i < 50; ++i)
+    m_policy.onSuppressionEnd(100);
+  BOOST_CHECK(maxSuppressionDelay(100000) <= time::milliseconds(2000));
+}
+
+BOOST_AUTO_TEST_CASE(IdleStretch)
+{
+  BOOST_CHECK(m_policy.getRetxDelay(10, m_rng) <= time::milliseconds(33000));
+
+  advanceClocks(time::seconds(90));
+  auto delay = m_policy.getRetxDelay(10, m_rng);
+  BOOST_CHECK(delay >= time::milliseconds(81000) && delay <= time::milliseconds(99000));
+
+  advanceClocks(time::seconds(1000));
+  BOOST_CHECK(m_policy.getRetxDelay(10, m_rng) <= time::milliseconds(132000));
+
+  m_policy.onActivity();
+  BOOST_CHECK(m_policy.getRetxDelay(10, m_rng) <= time::milliseconds(33000));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
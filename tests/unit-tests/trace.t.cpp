@@ -0,0 +1,126 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2021 University of California, Los Angeles
+ *
+ * This file is part of ndn-svs, synchronization library for distributed realtime
+ * applications for NDN.
+ *
+ * ndn-svs library is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, in version 2.1 of the License.
+ *
+ * ndn-svs library is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+ */
+
+#include "trace.hpp"
+
+#include "tests/boost-test.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+#ifdef NDN_SVS_WITH_TRACING
+
+namespace ndn {
+namespace svs {
+namespace test {
+
+using trace::Event;
+using trace::Record;
+
+// Rings are process-wide, so each test only looks at records of its own sources
+static std::vector<Record>
+collectFrom(const void* source)
+{
+  std::vector<Record> records;
+  for (const auto& r : trace::collect())
+  {
+    if (r.source == source)
+      records.push_back(r);
+  }
+  return records;
+}
+
+BOOST_AUTO_TEST_SUITE(TestTrace)
+
+BOOST_AUTO_TEST_CASE(Recording)
+{
+  int source = 0;
+  NDN_SVS_TRACE(Event::SYNC_RX, &source, 3);
+  NDN_SVS_TRACE(Event::MERGE_RESULT, &source, 1, 0);
+
+  auto records = collectFrom(&source);
+  BOOST_REQUIRE_EQUAL(records.size(), 2);
+  BOOST_CHECK(records[0].event == Event::SYNC_RX);
+  BOOST_CHECK_EQUAL(records[0].arg0, 3);
+  BOOST_CHECK_EQUAL(records[0].arg1, 0);
+  BOOST_CHECK(records[1].event == Event::MERGE_RESULT);
+  BOOST_CHECK_EQUAL(records[1].arg0, 1);
+  BOOST_CHECK_LE(records[0].time, records[1].time);
+
+  std::ostringstream os;
+  trace::print(os, {records[0]});
+  BOOST_CHECK_NE(os.str().find("\tsync-rx\t3\t0\n"), std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(WrapAround)
+{
+  // A fresh thread writes to a fresh ring
+  int source = 0;
+  std::thread([&] {
+    for (size_t i = 0; i < trace::RING_SIZE + 10; ++i)
+      NDN_SVS_TRACE(Event::FETCH_TX, &source, i);
+  }).join();
+
+  // Only the newest records are kept, oldest first
+  auto records = collectFrom(&source);
+  BOOST_REQUIRE_EQUAL(records.size(), trace::RING_SIZE);
+  BOOST_CHECK_EQUAL(records.front().arg0, 10);
+  BOOST_CHECK_EQUAL(records.back().arg0, trace::RING_SIZE + 9);
+  BOOST_CHECK(std::adjacent_find(records.begin(), records.end(), [] (const Record& a, const Record& b) {
+    return b.arg0 != a.arg0 + 1;
+  }) == records.end());
+}
+
+BOOST_AUTO_TEST_CASE(Threads)
+{
+  const size_t nThreads = 4;
+  const size_t nRecords = 1000;
+  int sources[nThreads] = {};
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < nThreads; ++t)
+  {
+    threads.emplace_back([&, t] {
+      for (size_t i = 0; i < nRecords; ++i)
+        NDN_SVS_TRACE(Event::SYNC_TX, &sources[t], i);
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  // Records of all threads are collected, each thread's in order
+  auto all = trace::collect();
+  BOOST_CHECK(std::is_sorted(all.begin(), all.end(), [] (const Record& a, const Record& b) {
+    return a.time < b.time;
+  }));
+
+  for (size_t t = 0; t < nThreads; ++t)
+  {
+    auto records = collectFrom(&sources[t]);
+    BOOST_REQUIRE_EQUAL(records.size(), nRecords);
+    for (size_t i = 0; i < nRecords; ++i)
+      BOOST_CHECK_EQUAL(records[i].arg0, i);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace svs
+} // namespace ndn
+
+#endif // NDN_SVS_WITH_TRACING
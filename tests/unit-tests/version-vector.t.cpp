@@ -48,6 +48,87 @@ BOOST_AUTO_TEST_CASE(Set)
   BOOST_CHECK_EQUAL(v.get("four"), 44);
 }
 
+BOOST_AUTO_TEST_CASE(Remove)
+{
+  BOOST_CHECK(v.remove("one"));
+  BOOST_CHECK(!v.remove("one"));
+  BOOST_CHECK(!v.has("one"));
+  BOOST_CHECK_EQUAL(v.get("one"), 0);
+  BOOST_CHECK_EQUAL(v.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Digest)
+{
+  uint64_t digest = v.getDigest();
+
+  VersionVector v2;
+  v2.set("two", 2);
+  v2.set("one", 1);
+  BOOST_CHECK_EQUAL(v2.getDigest(), digest);
+
+  // Updated incrementally after the first call
+  v2.set("three", 3);
+  BOOST_CHECK_NE(v2.getDigest(), digest);
+  v2.remove("three");
+  BOOST_CHECK_EQUAL(v2.getDigest(), digest);
+  v2.set("one", 5);
+  v.set("one", 5);
+  BOOST_CHECK_EQUAL(v2.getDigest(), v.getDigest());
+
+  VersionVector decoded(v2.encode());
+  BOOST_CHECK_EQUAL(decoded.getDigest(), v2.getDigest());
+}
+
+BOOST_AUTO_TEST_CASE(Partitions)
+{
+  v.setPartitionCount(8);
+  for (int i = 0; i < 50; ++i)
+    v.set("node-" + std::to_string(i), i + 1);
+  v.set("one", 10);
+  v.remove("two");
+
+  // Incremental digests match the ones computed from scratch
+  VersionVector v2;
+  for (const auto& entry : v)
+    v2.set(entry.first, entry.second);
+  v2.setPartitionCount(8);
+
+  size_t nEntries = 0;
+  for (size_t p = 0; p < 8; ++p)
+  {
+    BOOST_CHECK_EQUAL(v.getPartitionDigest(p), v2.getPartitionDigest(p));
+
+    auto entries = v.getPartitionEntries(p);
+    for (const auto& entry : entries)
+    {
+      BOOST_CHECK_EQUAL(VersionVector::getPartition(entry.first, 8), p);
+      BOOST_CHECK_EQUAL(entry.second, v.get(entry.first));
+    }
+    nEntries += entries.size();
+  }
+  BOOST_CHECK_EQUAL(nEntries, v.size());
+
+  // A change only affects the digest of its own partition
+  size_t p = VersionVector::getPartition("node-7", 8);
+  uint64_t before = v.getPartitionDigest(p);
+  v.set("node-7", 100);
+  BOOST_CHECK_NE(v.getPartitionDigest(p), before);
+  v.set("node-7", 8);
+  BOOST_CHECK_EQUAL(v.getPartitionDigest(p), before);
+
+  // Copies keep their own members, which outlive the original
+  auto copy = make_unique<VersionVector>(v);
+  v = VersionVector();
+  BOOST_CHECK_EQUAL(copy->getPartitionCount(), 8);
+  BOOST_CHECK_EQUAL(copy->getPartitionEntries(p).get("node-7"), 8);
+
+  // Removed entries leave their partition
+  copy->remove("node-7");
+  BOOST_CHECK(!copy->getPartitionEntries(p).has("node-7"));
+  BOOST_CHECK_EQUAL(copy->getPartitionDigest(p), before - VersionVector::hashEntry(
+    VersionVector::hashNode("node-7"), 8));
+}
+
 BOOST_AUTO_TEST_CASE(Iterate)
 {
   std::unordered_map<NodeID, SeqNo> umap;
@@ -80,6 +161,21 @@ BOOST_AUTO_TEST_CASE(DecodeStatic)
   BOOST_CHECK_EQUAL(dv.get("two"), 2);
 }
 
+BOOST_AUTO_TEST_CASE(DecodeUnsorted)
+{
+  // Entries of "two" and "one", in reverse order
+  const char* encoded = "\xCA\x03\x74\x77\x6F\xCB\x01\x02\xCA\x03\x6F\x6E\x65\xCB\x01\x01";
+  VersionVector dv(ndn::encoding::makeBinaryBlock(ndn::tlv::Content, encoded, 16));
+  BOOST_CHECK_EQUAL(dv.size(), 2);
+  BOOST_CHECK_EQUAL(dv.get("one"), 1);
+  BOOST_CHECK_EQUAL(dv.get("two"), 2);
+  BOOST_CHECK_EQUAL(dv.begin()->first, "one");
+
+  // A key without a value
+  BOOST_CHECK_THROW(VersionVector(ndn::encoding::makeBinaryBlock(ndn::tlv::Content, encoded, 5)),
+                    VersionVector::Error);
+}
+
 BOOST_AUTO_TEST_CASE(Ordering)
 {
   VersionVector v1;